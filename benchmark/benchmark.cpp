@@ -0,0 +1,459 @@
+/**
+ * @file benchmark.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Microbenchmarks of parser, writer, parameter validation and request dispatching.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <new>
+#include <time.h>
+#include <pthread.h>
+#include <jsonrpc/rpc.h>
+
+using namespace jsonrpc;
+using namespace std;
+
+/**
+ * Each benchmark runs at least this long (in milliseconds), unless another time is given on the command line.
+ */
+#define BENCHMARK_DEFAULT_TIME 500
+
+/**
+ * In --check-allocations mode, each benchmark is run this often after a warm up run, to get its steady state allocations.
+ */
+#define ALLOCATION_CHECK_ITERATIONS 10
+
+/**
+ * In --check-hot-replace mode, this many threads call a procedure this often, while it is replaced over and over.
+ */
+#define HOT_REPLACE_CALLERS 4
+#define HOT_REPLACE_CALLS 50000
+
+/**
+ * Every heap allocation is counted, to report allocations per operation. With glibc, malloc itself is interposed,
+ * so allocations of the C parts (mongoose, libcurl, strdup, ...) are included. Elsewhere only operator new is counted.
+ */
+static volatile unsigned long allocations = 0;
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* p, size_t size);
+    void __libc_free(void* p);
+
+    void* malloc(size_t size) throw ()
+    {
+        allocations++;
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) throw ()
+    {
+        allocations++;
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* p, size_t size) throw ()
+    {
+        allocations++;
+        return __libc_realloc(p, size);
+    }
+
+    void free(void* p) throw ()
+    {
+        __libc_free(p);
+    }
+}
+#else
+void* operator new(size_t size) throw (std::bad_alloc)
+{
+    allocations++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) throw (std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) throw ()
+{
+    free(p);
+}
+
+void operator delete[](void* p) throw ()
+{
+    free(p);
+}
+#endif
+
+typedef void (*benchmark_t)(void* data);
+
+/**
+ * Maximum number of allocations per operation in steady state. These numbers have been measured with glibc and
+ * libstdc++, a benchmark which allocates more fails the check. If an allocation is saved, lower the budget.
+ */
+typedef struct
+{
+        const char* benchmark;
+        unsigned long allocations;
+} allocationbudget_t;
+
+static const allocationbudget_t budgets[] =
+{
+    { "parse/small call", 31 },
+    { "write/small call", 8 },
+    { "validate/small call", 0 },
+    { "handle/small call", 51 },
+    { "parse/batch of 1000", 26008 },
+    { "write/batch of 1000", 4014 },
+    { "handle/batch of 1000", 44023 },
+    { "parse/10000 numbers", 10031 },
+    { "write/10000 numbers", 553 },
+    { "validate/10000 numbers", 0 },
+    { "handle/10000 numbers", 10050 },
+    { "parse/64 KB string", 32 },
+    { "write/64 KB string", 12 },
+    { "validate/64 KB string", 0 },
+    { "handle/64 KB string", 51 }
+};
+
+typedef struct
+{
+        string name;
+        string request;
+        Json::Value parsed;
+        string response;
+        Procedure* procedure;
+        RequestHandler* handler;
+} payload_t;
+
+static uint64_t now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * Runs the benchmark in rounds of growing size, until a round takes at least the given time, and reports this round.
+ */
+static void run(const string& name, benchmark_t benchmark, void* data,
+        size_t bytesPerOperation, unsigned int milliseconds)
+{
+    benchmark(data);
+
+    uint64_t iterations = 1;
+    while (true)
+    {
+        unsigned long allocationsBefore = allocations;
+        uint64_t start = now();
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            benchmark(data);
+        }
+        uint64_t elapsed = now() - start;
+        unsigned long allocated = allocations - allocationsBefore;
+
+        if (elapsed >= milliseconds * 1000000ULL)
+        {
+            double nsPerOperation = (double) elapsed / iterations;
+            printf("%-34s %10llu %12.1f ns/op %10.1f MB/s %8.1f allocs/op\n",
+                    name.c_str(), (unsigned long long) iterations,
+                    nsPerOperation,
+                    bytesPerOperation * 1000.0 / nsPerOperation,
+                    (double) allocated / iterations);
+            return;
+        }
+        //aim at the target time directly, but grow at most 100 fold per round
+        uint64_t next = elapsed > 0 ?
+                iterations * milliseconds * 1100000ULL / elapsed :
+                iterations * 100;
+        iterations = next > iterations * 100 ? iterations * 100 : (next > iterations ? next : iterations + 1);
+    }
+}
+
+/**
+ * Compares the steady state allocations of the benchmark with its budget.
+ * @return false if the budget is exceeded.
+ */
+static bool checkAllocations(const string& name, benchmark_t benchmark,
+        void* data)
+{
+    const allocationbudget_t* budget = NULL;
+    for (size_t i = 0; i < sizeof(budgets) / sizeof(budgets[0]); i++)
+    {
+        if (name == budgets[i].benchmark)
+        {
+            budget = &budgets[i];
+        }
+    }
+    if (budget == NULL)
+    {
+        printf("%-34s no budget\n", name.c_str());
+        return true;
+    }
+
+    benchmark(data);
+    unsigned long allocationsBefore = allocations;
+    for (int i = 0; i < ALLOCATION_CHECK_ITERATIONS; i++)
+    {
+        benchmark(data);
+    }
+    double allocated = (double) (allocations - allocationsBefore)
+            / ALLOCATION_CHECK_ITERATIONS;
+
+    bool ok = allocated <= budget->allocations;
+    printf("%-34s %10.1f allocs/op, budget %lu: %s\n", name.c_str(), allocated,
+            budget->allocations, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static void benchmarkParse(void* data)
+{
+    payload_t* payload = (payload_t*) data;
+    Json::Reader reader;
+    Json::Value value;
+    reader.parse(payload->request.data(),
+            payload->request.data() + payload->request.length(), value,
+            false);
+}
+
+static void benchmarkWrite(void* data)
+{
+    payload_t* payload = (payload_t*) data;
+    Json::FastWriter writer;
+    payload->response = writer.write(payload->parsed);
+}
+
+static void benchmarkValidate(void* data)
+{
+    payload_t* payload = (payload_t*) data;
+    payload->procedure->ValdiateParameters(
+            payload->parsed[KEY_REQUEST_PARAMETERS]);
+}
+
+static void benchmarkHandleRequest(void* data)
+{
+    payload_t* payload = (payload_t*) data;
+    payload->handler->HandleRequest(payload->request, payload->response);
+}
+
+//the procedures of the benchmark server, they do as little as possible
+static void sayHello(const Json::Value& request, Json::Value& response)
+{
+    response = "Hello: " + request["name"].asString();
+}
+
+static void sum(const Json::Value& request, Json::Value& response)
+{
+    const Json::Value& values = request["values"];
+    double result = 0;
+    for (unsigned int i = 0; i < values.size(); i++)
+    {
+        result += values[i].asDouble();
+    }
+    response = result;
+}
+
+static void length(const Json::Value& request, Json::Value& response)
+{
+    response = (Json::UInt) request["text"].asString().length();
+}
+
+static Procedure* addProcedure(RequestHandler& handler, const string& name,
+        const string& parameter, jsontype_t type, pRequest_t method)
+{
+    parameterlist_t parameters;
+    parameters[parameter] = type;
+    Procedure* procedure = new Procedure(name, RPC_METHOD, parameters);
+    procedure->SetMethodPointer(method);
+    handler.AddProcedure(procedure);
+    return procedure;
+}
+
+static string createCall(int id, const string& method, const string& params)
+{
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "{\"jsonrpc\":\"2.0\",\"id\":%d,", id);
+    return prefix + string("\"method\":\"") + method + "\",\"params\":" + params
+            + "}";
+}
+
+static payload_t createPayload(const string& name, const string& request,
+        Procedure* procedure, RequestHandler* handler)
+{
+    payload_t payload;
+    Json::Reader reader;
+    payload.name = name;
+    payload.request = request;
+    reader.parse(request, payload.parsed, false);
+    payload.procedure = procedure;
+    payload.handler = handler;
+    return payload;
+}
+
+typedef struct
+{
+        RequestHandler* handler;
+        unsigned long failures;
+        volatile int* running;
+} caller_t;
+
+static void* callWhileReplaced(void* data)
+{
+    caller_t* caller = (caller_t*) data;
+    string request = createCall(1, "sayHello", "{\"name\":\"Peter\"}");
+    string response;
+    for (int i = 0; i < HOT_REPLACE_CALLS; i++)
+    {
+        caller->handler->HandleRequest(request, response);
+        if (response.find("\"result\"") == string::npos)
+        {
+            caller->failures++;
+        }
+    }
+    __sync_fetch_and_sub(caller->running, 1);
+    return NULL;
+}
+
+/**
+ * Replaces a procedure while it is called by several threads, every call has to be answered by the old or the new procedure.
+ * @return false if a call failed (e.g. with METHOD_NOT_FOUND).
+ */
+static bool checkHotReplace()
+{
+    RequestHandler handler("hotreplace");
+    addProcedure(handler, "sayHello", "name", JSON_STRING, &sayHello);
+
+    volatile int running = HOT_REPLACE_CALLERS;
+    caller_t callers[HOT_REPLACE_CALLERS];
+    pthread_t threads[HOT_REPLACE_CALLERS];
+    for (int i = 0; i < HOT_REPLACE_CALLERS; i++)
+    {
+        callers[i].handler = &handler;
+        callers[i].failures = 0;
+        callers[i].running = &running;
+        pthread_create(&threads[i], NULL, &callWhileReplaced, &callers[i]);
+    }
+
+    unsigned long replacements = 0;
+    while (running > 0)
+    {
+        addProcedure(handler, "sayHello", "name", JSON_STRING, &sayHello);
+        replacements++;
+    }
+
+    unsigned long failures = 0;
+    for (int i = 0; i < HOT_REPLACE_CALLERS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        failures += callers[i].failures;
+    }
+    bool ok = failures == 0;
+    printf("%-34s %10lu replacements, %lu of %d calls failed: %s\n",
+            "hot replace", replacements, failures,
+            HOT_REPLACE_CALLERS * HOT_REPLACE_CALLS, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--check-hot-replace") == 0)
+    {
+        return checkHotReplace() ? 0 : 1;
+    }
+    bool check = argc > 1 && strcmp(argv[1], "--check-allocations") == 0;
+    const char* filter = argc > 1 && !check ? argv[1] : "";
+    unsigned int milliseconds =
+            argc > 2 ? atoi(argv[2]) : BENCHMARK_DEFAULT_TIME;
+    bool ok = true;
+
+    RequestHandler handler("benchmark");
+    Procedure* hello = addProcedure(handler, "sayHello", "name", JSON_STRING,
+            &sayHello);
+    Procedure* numbers = addProcedure(handler, "sum", "values", JSON_ARRAY,
+            &sum);
+    Procedure* text = addProcedure(handler, "length", "text", JSON_STRING,
+            &length);
+
+    string batch = "[";
+    for (int i = 0; i < 1000; i++)
+    {
+        batch += (i > 0 ? "," : "")
+                + createCall(i, "sayHello", "{\"name\":\"Peter\"}");
+    }
+    batch += "]";
+
+    string values = "{\"values\":[";
+    char number[32];
+    for (int i = 0; i < 10000; i++)
+    {
+        snprintf(number, sizeof(number), "%s%d.%d", i > 0 ? "," : "", i,
+                i % 7);
+        values += number;
+    }
+    values += "]}";
+
+    string longString = "{\"text\":\"";
+    for (int i = 0; i < 64 * 1024; i++)
+    {
+        longString += (char) ('a' + i % 26);
+    }
+    longString += "\"}";
+
+    vector<payload_t> payloads;
+    payloads.push_back(createPayload("small call",
+            createCall(1, "sayHello", "{\"name\":\"Peter\"}"), hello, &handler));
+    payloads.push_back(createPayload("batch of 1000", batch, hello, &handler));
+    payloads.push_back(createPayload("10000 numbers",
+            createCall(1, "sum", values), numbers, &handler));
+    payloads.push_back(createPayload("64 KB string",
+            createCall(1, "length", longString), text, &handler));
+
+    if (!check)
+    {
+        printf("%-34s %10s %15s %15s %17s\n", "benchmark", "iterations",
+                "time", "throughput", "allocations");
+    }
+    for (size_t i = 0; i < payloads.size(); i++)
+    {
+        payload_t& payload = payloads[i];
+        size_t size = payload.request.length();
+        string prefix[] = { "parse/", "write/", "validate/", "handle/" };
+        benchmark_t benchmarks[] = { &benchmarkParse, &benchmarkWrite,
+                &benchmarkValidate, &benchmarkHandleRequest };
+        for (int j = 0; j < 4; j++)
+        {
+            string name = prefix[j] + payload.name;
+            //a batch has no parameters to validate as a whole
+            if (strstr(name.c_str(), filter) == NULL
+                    || (benchmarks[j] == &benchmarkValidate
+                            && payload.parsed.isArray()))
+            {
+                continue;
+            }
+            if (check)
+            {
+                ok = checkAllocations(name, benchmarks[j], &payload) && ok;
+            }
+            else
+            {
+                run(name, benchmarks[j], &payload, size, milliseconds);
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+/**
+ * @file loadgenerator.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Open loop load generator for JSON-RPC servers over HTTP.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <jsonrpc/rpc.h>
+
+using namespace jsonrpc;
+using namespace std;
+
+#define DEFAULT_RATE 1000
+#define DEFAULT_DURATION 10
+#define DEFAULT_CONNECTIONS 16
+
+/**
+ * The load generator sends requests at a fixed rate, independent of how fast the server answers (open loop).
+ * Request i is due at start + i / rate. If all connections are busy, it is sent late, but its latency is still
+ * measured from the time it was due. This way, a stalling server can't hide its stall by slowing down the
+ * load generator (coordinated omission). The uncorrected service time is reported as well.
+ */
+typedef struct
+{
+        struct addrinfo* address;
+        string host;
+        vector<string> requests;
+        vector<bool> expectResponse;
+        uint64_t start;
+        uint64_t interval;
+        uint64_t count;
+        volatile uint64_t next;
+        volatile uint64_t errors;
+        LatencyHistogram latency;
+        LatencyHistogram serviceTime;
+} loadgenerator_t;
+
+static uint64_t now()
+{
+    return LatencyHistogram::Now();
+}
+
+static void sleepUntil(uint64_t time)
+{
+    uint64_t current = now();
+    if (time > current)
+    {
+        struct timespec pause;
+        pause.tv_sec = (time - current) / 1000000000ULL;
+        pause.tv_nsec = (time - current) % 1000000000ULL;
+        nanosleep(&pause, NULL);
+    }
+}
+
+/**
+ * @return an example value for a parameter of the given type.
+ */
+static Json::Value createValue(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_STRING:
+            return Json::Value("load");
+        case JSON_BOOLEAN:
+            return Json::Value(true);
+        case JSON_INTEGER:
+            return Json::Value(42);
+        case JSON_REAL:
+            return Json::Value(3.14);
+        case JSON_OBJECT:
+            return Json::Value(Json::objectValue);
+        case JSON_ARRAY:
+            return Json::Value(Json::arrayValue);
+    }
+    return Json::Value();
+}
+
+/**
+ * Creates one valid call for each procedure of the specification.
+ */
+static void createRequests(const string& specification, loadgenerator_t& generator)
+{
+    vector<Procedure*> procedures = Server::ParseProcedures(specification);
+    Json::FastWriter writer;
+    for (size_t i = 0; i < procedures.size(); i++)
+    {
+        Json::Value request;
+        request[KEY_REQUEST_VERSION] = JSON_RPC_VERSION;
+        request[KEY_REQUEST_METHODNAME] = procedures[i]->GetProcedureName();
+        request[KEY_REQUEST_PARAMETERS] = Json::Value(Json::objectValue);
+        const parameterlist_t& parameters = procedures[i]->GetParameters();
+        for (parameterlist_t::const_iterator it = parameters.begin();
+                it != parameters.end(); it++)
+        {
+            request[KEY_REQUEST_PARAMETERS][it->first] = createValue(it->second);
+        }
+        bool isMethod = procedures[i]->GetProcedureType() == RPC_METHOD;
+        if (isMethod)
+        {
+            request[KEY_REQUEST_ID] = (int) i + 1;
+        }
+
+        string body = writer.write(request);
+        char header[256];
+        snprintf(header, sizeof(header), "POST / HTTP/1.1\r\n"
+                "Host: %s\r\n"
+                "Content-Type: application/json\r\n"
+                "Content-Length: %lu\r\n"
+                "Connection: close\r\n\r\n", generator.host.c_str(),
+                (unsigned long) body.length());
+        generator.requests.push_back(header + body);
+        generator.expectResponse.push_back(isMethod);
+        delete procedures[i];
+    }
+}
+
+/**
+ * Sends the request on a new connection and reads the whole response.
+ * @return false if the request failed or the server did not answer with 200 OK.
+ */
+static bool sendRequest(const loadgenerator_t& generator, const string& request,
+        bool expectResponse)
+{
+    struct addrinfo* address = generator.address;
+    int sock = socket(address->ai_family, address->ai_socktype,
+            address->ai_protocol);
+    if (sock < 0)
+    {
+        return false;
+    }
+    int on = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    if (connect(sock, address->ai_addr, address->ai_addrlen) != 0
+            || send(sock, request.data(), request.length(), 0)
+                    != (ssize_t) request.length())
+    {
+        close(sock);
+        return false;
+    }
+
+    char buffer[4096];
+    string status;
+    ssize_t n;
+    while ((n = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+    {
+        if (status.length() < 12)
+        {
+            status.append(buffer, n < 12 ? n : 12);
+        }
+    }
+    close(sock);
+
+    //notifications are not answered at all
+    if (!expectResponse && status.empty())
+    {
+        return n == 0;
+    }
+    return n == 0 && status.compare(0, 12, "HTTP/1.1 200") == 0;
+}
+
+static void* generateLoad(void* data)
+{
+    loadgenerator_t* generator = (loadgenerator_t*) data;
+    while (true)
+    {
+        uint64_t i = __sync_fetch_and_add(&generator->next, 1);
+        if (i >= generator->count)
+        {
+            break;
+        }
+        uint64_t due = generator->start + i * generator->interval;
+        sleepUntil(due);
+
+        size_t index = i % generator->requests.size();
+        uint64_t sent = now();
+        if (!sendRequest(*generator, generator->requests[index],
+                generator->expectResponse[index]))
+        {
+            __sync_fetch_and_add(&generator->errors, 1);
+        }
+        uint64_t received = now();
+        generator->latency.Record(received - due);
+        generator->serviceTime.Record(received - sent);
+    }
+    return NULL;
+}
+
+static void printLatencies(const char* name, const LatencyHistogram& histogram)
+{
+    printf("%-14s p50 %9.3f ms  p90 %9.3f ms  p99 %9.3f ms  p99.9 %9.3f ms  max %9.3f ms\n",
+            name, histogram.GetValueAtQuantile(0.5) / 1e6,
+            histogram.GetValueAtQuantile(0.9) / 1e6,
+            histogram.GetValueAtQuantile(0.99) / 1e6,
+            histogram.GetValueAtQuantile(0.999) / 1e6,
+            histogram.GetMax() / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        cerr << "usage: " << argv[0]
+                << " procedures.json [host:port] [requests/s] [seconds] [connections]"
+                << endl;
+        return -1;
+    }
+
+    string target = argc > 2 ? argv[2] : "localhost:8080";
+    double rate = argc > 3 ? atof(argv[3]) : DEFAULT_RATE;
+    double duration = argc > 4 ? atof(argv[4]) : DEFAULT_DURATION;
+    int connections = argc > 5 ? atoi(argv[5]) : DEFAULT_CONNECTIONS;
+    if (rate <= 0 || duration <= 0 || connections <= 0)
+    {
+        cerr << "rate, duration and connections must be positive" << endl;
+        return -1;
+    }
+
+    loadgenerator_t* generator = new loadgenerator_t();
+    size_t colon = target.rfind(':');
+    generator->host = target.substr(0, colon);
+    string port = colon == string::npos ? "8080" : target.substr(colon + 1);
+
+    try
+    {
+        createRequests(argv[1], *generator);
+    }
+    catch (const Exception& e)
+    {
+        cerr << e.GetMessage() << endl;
+        return -1;
+    }
+    if (generator->requests.empty())
+    {
+        cerr << "no procedures found in " << argv[1] << endl;
+        return -1;
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(generator->host.c_str(), port.c_str(), &hints,
+            &generator->address) != 0)
+    {
+        cerr << "could not resolve " << target << endl;
+        return -1;
+    }
+
+    generator->interval = (uint64_t) (1e9 / rate);
+    generator->count = (uint64_t) (rate * duration);
+    generator->next = 0;
+    generator->errors = 0;
+    generator->start = now();
+
+    vector<pthread_t> threads(connections);
+    for (int i = 0; i < connections; i++)
+    {
+        pthread_create(&threads[i], NULL, &generateLoad, generator);
+    }
+    for (int i = 0; i < connections; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = (now() - generator->start) / 1e9;
+
+    printf("target         %s, %d procedures, %.0f requests/s for %.1f s on %d connections\n",
+            target.c_str(), (int) generator->requests.size(), rate, duration,
+            connections);
+    printf("requests       %llu, errors %llu, %.1f requests/s achieved\n",
+            (unsigned long long) generator->count,
+            (unsigned long long) generator->errors,
+            generator->count / elapsed);
+    printLatencies("latency", generator->latency);
+    printLatencies("service time", generator->serviceTime);
+
+    int result = generator->errors > 0 ? 1 : 0;
+    freeaddrinfo(generator->address);
+    delete generator;
+    return result;
+}
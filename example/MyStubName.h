@@ -10,6 +10,10 @@
 #include <string>
 #include <json/json.h>
 
+/**
+ * Requests are written directly into a buffer and results are read directly out of the response.
+ * Each call has its own buffers, so the stub may be called by several threads at once, if its connector allows it.
+ */
 class MyStubName
 {
     public:
@@ -22,19 +26,25 @@ class MyStubName
             delete this->client;
         }
 
-        Json::Value sayHello(const std::string& name)
+        std::string sayHello(const std::string& name) throw (jsonrpc::Exception)
         {
-            Json::Value p;
-            p["name"] = name; 
-
-            return this->client->CallMethod("sayHello",p);
+            jsonrpc::RequestBuffer rpcRequest;
+            rpcRequest.Begin("sayHello", 1);
+            rpcRequest.AddParameter("name", name);
+            std::string rpcResponse;
+            jsonrpc::JsonScanner rpcResult;
+            this->client->CallMethod(rpcRequest, rpcResponse, rpcResult);
+            std::string returnValue;
+            if (!rpcResult.Read(returnValue))
+                throw jsonrpc::Exception(ERROR_PARSING_JSON, rpcResponse);
+            return returnValue;
         }
 
-        void notifyServer()
+        void notifyServer() throw (jsonrpc::Exception)
         {
-            Json::Value p;
-            
-            this->client->CallMethod("notifyServer",p);
+            jsonrpc::RequestBuffer rpcRequest;
+            rpcRequest.Begin("notifyServer", 0);
+            this->client->CallNotification(rpcRequest);
         }
 
     private:
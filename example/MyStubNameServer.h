@@ -0,0 +1,126 @@
+/**
+ * THIS FILE IS GENERATED BY jsonrpcstub, DO NOT CHANGE IT!!!!!
+ */
+
+#ifndef _MYSTUBNAMESERVER_H_
+#define _MYSTUBNAMESERVER_H_
+
+#include <jsonrpc/rpc.h>
+#include <string>
+#include <json/json.h>
+
+class MyStubNameServer : public jsonrpc::Server, public jsonrpc::ProcedureHandler
+{
+    public:
+        MyStubNameServer(const std::string& name, const std::string& configfile, jsonrpc::ServerConnector* conn, jsonrpc::Authenticator* auth = NULL)
+            : jsonrpc::Server(name, configfile, conn, auth)
+        {
+            jsonrpc::parameterlist_t parameters;
+            for (int i = 0; i < 2; i++)
+                this->procedures[i] = NULL;
+            parameters.clear();
+            parameters["name"] = jsonrpc::JSON_STRING;
+            if (!this->BindProcedure(jsonrpc::Procedure("sayHello", jsonrpc::RPC_METHOD, parameters), this, 0, &MyStubNameServer::Validate_sayHello))
+                throw jsonrpc::Exception(ERROR_METHOD_NOT_FOUND, "sayHello");
+            parameters.clear();
+            if (!this->BindProcedure(jsonrpc::Procedure("notifyServer", jsonrpc::RPC_NOTIFICATION, parameters), this, 1, &MyStubNameServer::Validate_notifyServer))
+                throw jsonrpc::Exception(ERROR_METHOD_NOT_FOUND, "notifyServer");
+        }
+
+        MyStubNameServer(const std::string& name, jsonrpc::ServerConnector* conn, jsonrpc::Authenticator* auth = NULL)
+            : jsonrpc::Server(name, conn, auth)
+        {
+            jsonrpc::parameterlist_t parameters;
+            parameters.clear();
+            parameters["name"] = jsonrpc::JSON_STRING;
+            this->procedures[0] = new jsonrpc::Procedure("sayHello", jsonrpc::RPC_METHOD, parameters);
+            this->procedures[0]->SetReturnType(jsonrpc::JSON_STRING);
+            this->procedures[0]->SetValidator(&MyStubNameServer::Validate_sayHello);
+            this->procedures[0]->SetHandler(this, 0);
+            this->GetHandler().AddProcedure(this->procedures[0]);
+            if (!this->GetHandler().GetProcedureRegistry().Acquire(this->procedures[0]))
+                this->procedures[0] = NULL;
+            parameters.clear();
+            this->procedures[1] = new jsonrpc::Procedure("notifyServer", jsonrpc::RPC_NOTIFICATION, parameters);
+            this->procedures[1]->SetValidator(&MyStubNameServer::Validate_notifyServer);
+            this->procedures[1]->SetHandler(this, 1);
+            this->GetHandler().AddProcedure(this->procedures[1]);
+            if (!this->GetHandler().GetProcedureRegistry().Acquire(this->procedures[1]))
+                this->procedures[1] = NULL;
+            this->GetHandler().SetProcedureLookup(&MyStubNameServer::FindProcedure, this);
+        }
+
+        virtual ~MyStubNameServer()
+        {
+            this->GetHandler().SetProcedureLookup(NULL, NULL);
+            for (int i = 0; i < 2; i++)
+                if (this->procedures[i] != NULL)
+                    this->GetHandler().GetProcedureRegistry().Release(this->procedures[i]);
+        }
+
+        virtual std::string sayHello(const std::string& name) = 0;
+        virtual void notifyServer() = 0;
+
+        virtual void HandleMethodCall(jsonrpc::Procedure& procedure, const Json::Value& parameter, Json::Value& result)
+        {
+            const Json::Value* arg[1];
+            jsonrpc::ProcedureHandler::GetArguments(procedure, parameter, arg);
+            switch (procedure.GetHandlerId())
+            {
+                case 0:
+                {
+                    result = this->sayHello((*arg[0]).asString());
+                    break;
+                }
+            }
+        }
+
+        virtual void HandleNotificationCall(jsonrpc::Procedure& procedure, const Json::Value& parameter)
+        {
+            const Json::Value* arg[1];
+            jsonrpc::ProcedureHandler::GetArguments(procedure, parameter, arg);
+            switch (procedure.GetHandlerId())
+            {
+                case 1:
+                {
+                    this->notifyServer();
+                    break;
+                }
+            }
+        }
+
+    private:
+        /**
+         * The compiled procedures, with a reference each, so FindProcedure can return them even after they have been removed.
+         */
+        jsonrpc::Procedure* procedures[2];
+
+        static int Validate_sayHello(const Json::Value& parameter)
+        {
+            if (!parameter.isObject())
+                return ERROR_INVALID_PARAMS;
+            if (!parameter["name"].isString())
+                return ERROR_INVALID_PARAMS;
+            return ERROR_NO;
+        }
+
+        static int Validate_notifyServer(const Json::Value& parameter)
+        {
+            if (parameter.isArray() && parameter.size() > 0)
+                return ERROR_INVALID_PARAMS;
+            return ERROR_NO;
+        }
+
+        static jsonrpc::Procedure* FindProcedure(void* server, const std::string& name)
+        {
+            static const int slots[4] = { 0, -1, -1, 1 };
+            int slot = slots[jsonrpc::RequestHandler::HashProcedureName(name, 0u) & 3];
+            if (slot >= 0 && ((MyStubNameServer*) server)->procedures[slot] != NULL
+                    && ((MyStubNameServer*) server)->procedures[slot]->GetProcedureName() == name)
+            {
+                return ((MyStubNameServer*) server)->procedures[slot];
+            }
+            return NULL;
+        }
+};
+#endif //_MYSTUBNAMESERVER_H_
@@ -0,0 +1,72 @@
+/**
+ * @file memberserver.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Server whose procedures are added without configuration file and call member functions.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <iostream>
+#include <jsonrpc/rpc.h>
+
+using namespace jsonrpc;
+using namespace std;
+
+class Greeter
+{
+    public:
+        Greeter(const string& greeting)
+                : greeting(greeting), notifications(0)
+        {
+        }
+
+        void sayHello(const Json::Value& request, Json::Value& response)
+        {
+            response = this->greeting + ": " + request["name"].asString();
+        }
+
+        void notifyServer(const Json::Value& request)
+        {
+            __sync_fetch_and_add(&this->notifications, 1);
+            cout << "server received some Notification" << endl;
+        }
+
+    private:
+        string greeting;
+        volatile int notifications;
+};
+
+int main()
+{
+    Greeter greeter("Hello");
+
+    try
+    {
+        Server serv("samplejsonrpcserver", new HttpServer(8080));
+
+        parameterlist_t parameters;
+        parameters["name"] = JSON_STRING;
+        serv.AddProcedure(new Procedure("sayHello", RPC_METHOD, parameters),
+                MakeMethodHandler(&greeter, &Greeter::sayHello));
+        serv.AddProcedure(
+                new Procedure("notifyServer", RPC_NOTIFICATION, parameterlist_t()),
+                MakeNotificationHandler(&greeter, &Greeter::notifyServer));
+
+        if (serv.StartListening())
+        {
+            cout << "Server started successfully" << endl;
+            getchar();
+            serv.StopListening();
+        }
+        else
+        {
+            cout << "Error starting Server" << endl;
+        }
+    }
+    catch (jsonrpc::Exception& e)
+    {
+        cerr << e.what() << endl;
+    }
+    //curl --data "{\"jsonrpc\":\"2.0\",\"method\":\"sayHello\",\"id\":1,\"params\":{\"name\":\"peter\"}}" localhost:8080
+}
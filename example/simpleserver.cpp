@@ -48,6 +48,8 @@ int main(int argc, char** argv)
 
             Server serv("samplejsonrpcserver", argv[1],
                     procedurePointers, notPointers, new HttpServer(8080));
+            //changes of the specification are applied without restarting the server
+            serv.StartWatching();
             if (serv.StartListening())
             {
                 cout << "Server started successfully" << endl;
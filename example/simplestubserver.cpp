@@ -0,0 +1,65 @@
+/**
+ * @file simplestubserver.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Implements the server stub generated by jsonrpcstub for res/procedures.json
+ */
+
+#include <stdio.h>
+#include <string>
+#include <iostream>
+#include <jsonrpc/rpc.h>
+#include "MyStubNameServer.h"
+
+using namespace jsonrpc;
+using namespace std;
+
+class MyServer : public MyStubNameServer
+{
+    public:
+        MyServer()
+            : MyStubNameServer("samplestubserver", new HttpServer(8080))
+        {
+        }
+
+        MyServer(const std::string& configfile)
+            : MyStubNameServer("samplestubserver", configfile, new HttpServer(8080))
+        {
+        }
+
+        virtual std::string sayHello(const std::string& name)
+        {
+            cout << "Requested say Hello" << endl;
+            return "Hello: " + name;
+        }
+
+        virtual void notifyServer()
+        {
+            cout << "server received some Notification" << endl;
+        }
+};
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        //without a specification file, the one compiled into the stub is used
+        MyServer* serv = argc < 2 ? new MyServer() : new MyServer(argv[1]);
+        if (serv->StartListening())
+        {
+            cout << "Server started successfully" << endl;
+            getchar();
+            serv->StopListening();
+        }
+        else
+        {
+            cout << "Error starting Server" << endl;
+        }
+        delete serv;
+    }
+    catch (jsonrpc::Exception& e)
+    {
+        cerr << e.what() << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file callbackhandler.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ProcedureHandlers which call member functions of an object or callable objects.
+ */
+
+#ifndef CALLBACKHANDLER_H_
+#define CALLBACKHANDLER_H_
+
+#include <json/json.h>
+
+#include "procedurehandler.h"
+
+namespace jsonrpc
+{
+    /**
+     * Calls a member function of an object, the object carries the state of the procedure instead of globals.
+     * Requests are handled by several threads at once, so the object has to synchronize its state itself
+     * (e.g. by keeping it per thread or in shards).
+     */
+    template<class T>
+    class MemberHandler: public ProcedureHandler
+    {
+        public:
+            typedef void (T::*pMethod_t)(const Json::Value&, Json::Value&);
+            typedef void (T::*pNotification_t)(const Json::Value&);
+
+            MemberHandler(T* object, pMethod_t method)
+                    : object(object), method(method), notification(NULL)
+            {
+            }
+
+            MemberHandler(T* object, pNotification_t notification)
+                    : object(object), method(NULL), notification(notification)
+            {
+            }
+
+            virtual void HandleMethodCall(Procedure&,
+                    const Json::Value& parameter, Json::Value& result)
+            {
+                (this->object->*this->method)(parameter, result);
+            }
+
+            virtual void HandleNotificationCall(Procedure&,
+                    const Json::Value& parameter)
+            {
+                (this->object->*this->notification)(parameter);
+            }
+
+            virtual bool Handles(procedure_t type) const
+            {
+                return type == RPC_METHOD ?
+                        this->method != NULL : this->notification != NULL;
+            }
+
+        private:
+            T* object;
+            pMethod_t method;
+            pNotification_t notification;
+    };
+
+    /**
+     * Calls a copy of a callable object as method, e.g. a functor or a std::function, with (const Json::Value&, Json::Value&).
+     */
+    template<class F>
+    class CallableMethodHandler: public ProcedureHandler
+    {
+        public:
+            CallableMethodHandler(const F& callable)
+                    : callable(callable)
+            {
+            }
+
+            virtual void HandleMethodCall(Procedure&,
+                    const Json::Value& parameter, Json::Value& result)
+            {
+                this->callable(parameter, result);
+            }
+
+            virtual void HandleNotificationCall(Procedure&, const Json::Value&)
+            {
+            }
+
+            virtual bool Handles(procedure_t type) const
+            {
+                return type == RPC_METHOD;
+            }
+
+        private:
+            F callable;
+    };
+
+    /**
+     * Calls a copy of a callable object as notification, with (const Json::Value&).
+     */
+    template<class F>
+    class CallableNotificationHandler: public ProcedureHandler
+    {
+        public:
+            CallableNotificationHandler(const F& callable)
+                    : callable(callable)
+            {
+            }
+
+            virtual void HandleMethodCall(Procedure&, const Json::Value&,
+                    Json::Value&)
+            {
+            }
+
+            virtual void HandleNotificationCall(Procedure&,
+                    const Json::Value& parameter)
+            {
+                this->callable(parameter);
+            }
+
+            virtual bool Handles(procedure_t type) const
+            {
+                return type == RPC_NOTIFICATION;
+            }
+
+        private:
+            F callable;
+    };
+
+    /**
+     * These create the handlers above, e.g. for Server::AddProcedure:
+     *      server.AddProcedure(new Procedure("add", RPC_METHOD, parameters), MakeMethodHandler(&calculator, &Calculator::Add));
+     */
+    template<class T>
+    ProcedureHandler* MakeMethodHandler(T* object,
+            void (T::*method)(const Json::Value&, Json::Value&))
+    {
+        return new MemberHandler<T>(object, method);
+    }
+
+    template<class T>
+    ProcedureHandler* MakeNotificationHandler(T* object,
+            void (T::*notification)(const Json::Value&))
+    {
+        return new MemberHandler<T>(object, notification);
+    }
+
+    template<class F>
+    ProcedureHandler* MakeMethodHandler(const F& callable)
+    {
+        return new CallableMethodHandler<F>(callable);
+    }
+
+    template<class F>
+    ProcedureHandler* MakeNotificationHandler(const F& callable)
+    {
+        return new CallableNotificationHandler<F>(callable);
+    }
+
+} /* namespace jsonrpc */
+#endif /* CALLBACKHANDLER_H_ */
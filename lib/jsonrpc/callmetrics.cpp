@@ -0,0 +1,74 @@
+/**
+ * @file callmetrics.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Call counters and per phase latency histograms.
+ */
+
+#include "callmetrics.h"
+
+namespace jsonrpc
+{
+    CallMetrics::CallMetrics()
+            : calls(0), errors(0)
+    {
+    }
+
+    void CallMetrics::RecordCall()
+    {
+        __sync_fetch_and_add(&this->calls, 1);
+    }
+
+    void CallMetrics::RecordError()
+    {
+        __sync_fetch_and_add(&this->errors, 1);
+    }
+
+    void CallMetrics::RecordPhase(phase_t phase, uint64_t nanoseconds)
+    {
+        this->phases[phase].Record(nanoseconds);
+    }
+
+    uint64_t CallMetrics::GetCalls() const
+    {
+        return this->calls;
+    }
+
+    uint64_t CallMetrics::GetErrors() const
+    {
+        return this->errors;
+    }
+
+    const LatencyHistogram& CallMetrics::GetHistogram(phase_t phase) const
+    {
+        return this->phases[phase];
+    }
+
+    void CallMetrics::Reset()
+    {
+        this->calls = 0;
+        this->errors = 0;
+        for (int i = 0; i < PHASE_COUNT; i++)
+        {
+            this->phases[i].Reset();
+        }
+    }
+
+    const char* CallMetrics::GetPhaseName(phase_t phase)
+    {
+        switch (phase)
+        {
+            case PHASE_PARSE:
+                return "parse";
+            case PHASE_VALIDATE:
+                return "validate";
+            case PHASE_EXECUTE:
+                return "execute";
+            case PHASE_SERIALIZE:
+                return "serialize";
+            default:
+                return "unknown";
+        }
+    }
+
+} /* namespace jsonrpc */
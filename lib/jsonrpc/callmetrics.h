@@ -0,0 +1,54 @@
+/**
+ * @file callmetrics.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Call counters and per phase latency histograms.
+ */
+
+#ifndef CALLMETRICS_H_
+#define CALLMETRICS_H_
+
+#include "latencyhistogram.h"
+
+namespace jsonrpc
+{
+    /**
+     * The phases, in which the processing of a request is measured.
+     */
+    typedef enum
+    {
+        PHASE_PARSE, PHASE_VALIDATE, PHASE_EXECUTE, PHASE_SERIALIZE, PHASE_COUNT
+    } phase_t;
+
+    /**
+     * This class holds the counters and latency histograms, either of a single procedure or of all requests
+     * of a RequestHandler. All methods are lock free and may be called from several threads at the same time.
+     */
+    class CallMetrics
+    {
+        public:
+            CallMetrics();
+
+            void RecordCall();
+            void RecordError();
+            void RecordPhase(phase_t phase, uint64_t nanoseconds);
+
+            uint64_t GetCalls() const;
+            uint64_t GetErrors() const;
+            const LatencyHistogram& GetHistogram(phase_t phase) const;
+
+            void Reset();
+
+            /**
+             * @return the name of the phase, e.g. for log output.
+             */
+            static const char* GetPhaseName(phase_t phase);
+
+        private:
+            volatile uint64_t calls;
+            volatile uint64_t errors;
+            LatencyHistogram phases[PHASE_COUNT];
+    };
+
+} /* namespace jsonrpc */
+#endif /* CALLMETRICS_H_ */
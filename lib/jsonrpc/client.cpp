@@ -24,54 +24,84 @@ namespace jsonrpc
     Json::Value Client::CallMethod(const std::string& name,
                                    const Json::Value& parameter) throw(Exception)
     {
-        Json::FastWriter writer;
-        Json::Reader reader;
         Json::Value result;
 
         int id = 1;
 
-        std::string str_result = this->connector->SendMessage(
-                writer.write(this->BuildRequestObject(name, parameter, id)));
+        this->connector->SendRequest(
+                this->BuildRequestObject(name, parameter, id), result);
 
-        if (reader.parse(str_result, result, false))
+        if (validateResponse)
         {
-            if (validateResponse)
+            if (result[KEY_RESPONSE_ERROR] != Json::nullValue)
             {
-                if (result[KEY_RESPONSE_ERROR] != Json::nullValue)
-                {
-                    throw Exception(result[KEY_RESPONSE_ERROR][KEY_ERROR_CODE].asInt());
-                }
+                throw Exception(result[KEY_RESPONSE_ERROR][KEY_ERROR_CODE].asInt());
+            }
 
-                if (result[KEY_RESPONSE_RESULT] == Json::nullValue)
-                {
-                    throw Exception(ERROR_NO_RESULT_IN_RESPONSE);
-                }
+            if (result[KEY_RESPONSE_RESULT] == Json::nullValue)
+            {
+                throw Exception(ERROR_NO_RESULT_IN_RESPONSE);
+            }
 
-                if (result[KEY_REQUEST_ID].asInt() != id)
-                {
-                    throw Exception(ERROR_REQUEST_RESPONSE_ID_MISMATCH,
-                            str_result + " / "
-                                    + writer.write(
-                                            this->BuildRequestObject(name,
-                                                    parameter, id)));
-                }
+            if (result[KEY_REQUEST_ID].asInt() != id)
+            {
+                Json::FastWriter writer;
+                throw Exception(ERROR_REQUEST_RESPONSE_ID_MISMATCH,
+                        writer.write(result) + " / "
+                                + writer.write(
+                                        this->BuildRequestObject(name,
+                                                parameter, id)));
             }
-            return result[KEY_RESPONSE_RESULT];
-        }
-        else
-        {
-            throw Exception(ERROR_PARSING_JSON,
-                    "Server response could not be parsed: " + str_result);
         }
-
-        return Json::nullValue;
+        return result[KEY_RESPONSE_RESULT];
     }
     
     void Client::CallNotification(const std::string& name,
                                   const Json::Value& parameter) throw(Exception)
     {
-        Json::FastWriter writer;
-        this->connector->SendMessage(writer.write(this->BuildRequestObject(name,parameter, -1)));
+        Json::Value result;
+        this->connector->SendRequest(this->BuildRequestObject(name, parameter, -1), result);
+    }
+
+    void Client::CallMethod(RequestBuffer& request, std::string& response,
+            JsonScanner& result) throw (Exception)
+    {
+        response = this->connector->SendMessage(request.End());
+        result.Reset(response.data(), response.length());
+
+        const char* name;
+        size_t length;
+        if (result.BeginObject())
+        {
+            while (result.NextMember(name, length))
+            {
+                if (JsonScanner::Matches(name, length, KEY_RESPONSE_RESULT))
+                {
+                    return;
+                }
+                else if (JsonScanner::Matches(name, length, KEY_RESPONSE_ERROR))
+                {
+                    Json::Value error;
+                    if (result.Read(error) && error.isObject())
+                    {
+                        throw Exception(error[KEY_ERROR_CODE].asInt());
+                    }
+                    break;
+                }
+                result.Skip();
+            }
+            if (!result.Failed())
+            {
+                throw Exception(ERROR_NO_RESULT_IN_RESPONSE);
+            }
+        }
+        throw Exception(ERROR_PARSING_JSON,
+                "Server response could not be parsed: " + response);
+    }
+
+    void Client::CallNotification(RequestBuffer& request) throw (Exception)
+    {
+        this->connector->SendMessage(request.End());
     }
 
    /* std::vector<Json::Value> Client::BatchCallMethod(
@@ -10,6 +10,8 @@
 
 #include "clientconnector.h"
 #include "exception.h"
+#include "requestbuffer.h"
+#include "jsonscanner.h"
 #include <json/json.h>
 
 #include <vector>
@@ -29,6 +31,16 @@ namespace jsonrpc
             Json::Value CallMethod(const std::string& name, const Json::Value& paramter) throw (Exception);
             void CallNotification(const std::string& name, const Json::Value& paramter) throw (Exception);
 
+            /**
+             * Sends a request written by a RequestBuffer. The response is not parsed, it is only scanned up to its result.
+             * Error responses are always thrown as Exception, the id of the response is not checked.
+             * @param response - will hold the response, it must not change while result is used.
+             * @param result - stands on the result value afterwards, to read it directly into typed variables.
+             * @throws Exception with the code of an error response, ERROR_NO_RESULT_IN_RESPONSE or ERROR_PARSING_JSON.
+             */
+            void CallMethod(RequestBuffer& request, std::string& response, JsonScanner& result) throw (Exception);
+            void CallNotification(RequestBuffer& request) throw (Exception);
+
 
         private:
            ClientConnector* connector;
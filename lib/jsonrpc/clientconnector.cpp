@@ -0,0 +1,30 @@
+/**
+ * @file clientconnector.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief to be defined
+ */
+
+#include "clientconnector.h"
+
+using namespace std;
+
+namespace jsonrpc
+{
+
+    void ClientConnector::SendRequest(const Json::Value& request,
+            Json::Value& response) throw (Exception)
+    {
+        Json::FastWriter writer;
+        Json::Reader reader;
+
+        string str_result = this->SendMessage(writer.write(request));
+
+        if (!reader.parse(str_result, response, false))
+        {
+            throw Exception(ERROR_PARSING_JSON,
+                    "Server response could not be parsed: " + str_result);
+        }
+    }
+
+} /* namespace jsonrpc */
@@ -9,6 +9,9 @@
 #define CLIENTCONNECTOR_H_
 
 #include <string>
+#include <json/json.h>
+
+#include "exception.h"
 
 namespace jsonrpc
 {
@@ -23,6 +26,14 @@ namespace jsonrpc
              * The result of the request must be returned as string.
              */
             virtual std::string SendMessage(const std::string& message) = 0;
+
+            /**
+             * This method is used by Client to send a request object and receive the parsed response.
+             * The default implementation serializes the request, calls SendMessage and parses the result.
+             * Connectors which don't need a textual representation (e.g. in-process connectors) can override it.
+             * @throws Exception with ERROR_PARSING_JSON if the response could not be parsed.
+             */
+            virtual void SendRequest(const Json::Value& request, Json::Value& response) throw (Exception);
     };
 
 } /* namespace jsonrpc */
@@ -70,6 +70,8 @@ namespace jsonrpc
 
         curl_easy_setopt(curl, CURLOPT_URL, this->url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writefunc);
+        //an empty string announces all encodings libcurl supports, responses are decompressed transparently.
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
     }
     
     HttpClient::~HttpClient()
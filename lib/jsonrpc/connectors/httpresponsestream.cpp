@@ -0,0 +1,125 @@
+/**
+ * @file httpresponsestream.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Sends a HTTP response in pieces, using chunked transfer encoding.
+ */
+
+#include "httpresponsestream.h"
+#include <cstdio>
+#include <cstring>
+
+/**
+ * Size of the buffer for compressed output, a chunk is sent whenever it is full.
+ */
+#define COMPRESSION_CHUNK_SIZE (64 * 1024)
+
+namespace jsonrpc
+{
+    HttpResponseStream::HttpResponseStream(struct mg_connection* conn,
+            contentencoding_t encoding, int level)
+            : conn(conn), encoding(encoding), level(level), compressing(false)
+    {
+        memset(&this->stream, 0, sizeof(this->stream));
+    }
+
+    HttpResponseStream::~HttpResponseStream()
+    {
+        if (this->compressing)
+        {
+            deflateEnd(&this->stream);
+        }
+    }
+
+    bool HttpResponseStream::Begin()
+    {
+        const char* contentEncoding = "";
+        if (this->encoding != ENCODING_IDENTITY)
+        {
+            //windowBits + 16 makes zlib write a gzip instead of a zlib wrapper
+            int windowBits = this->encoding == ENCODING_GZIP ? 15 + 16 : 15;
+            if (deflateInit2(&this->stream, this->level, Z_DEFLATED, windowBits,
+                    8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                return false;
+            }
+            this->compressing = true;
+            this->output.resize(COMPRESSION_CHUNK_SIZE);
+            contentEncoding =
+                    this->encoding == ENCODING_GZIP ?
+                            "Content-Encoding: gzip\r\n" :
+                            "Content-Encoding: deflate\r\n";
+        }
+
+        return mg_printf(this->conn, "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/plain\r\n"
+                "%s"
+                "Transfer-Encoding: chunked\r\n"
+                "Vary: Accept-Encoding\r\n"
+                "\r\n", contentEncoding) > 0;
+    }
+
+    bool HttpResponseStream::Write(const char* data, size_t length)
+    {
+        if (length == 0)
+        {
+            return true;
+        }
+        if (this->compressing)
+        {
+            return this->Deflate(data, length, Z_NO_FLUSH);
+        }
+        return this->WriteChunk(data, length);
+    }
+
+    bool HttpResponseStream::End()
+    {
+        bool ok = true;
+        if (this->compressing)
+        {
+            ok = this->Deflate(NULL, 0, Z_FINISH);
+        }
+        return ok && mg_write(this->conn, "0\r\n\r\n", 5) == 5;
+    }
+
+    bool HttpResponseStream::WriteChunk(const char* data, size_t length)
+    {
+        char chunkHeader[20];
+        int chunkHeaderLength = snprintf(chunkHeader, sizeof(chunkHeader),
+                "%lx\r\n", (unsigned long) length);
+        return mg_write(this->conn, chunkHeader, chunkHeaderLength)
+                == chunkHeaderLength
+                && mg_write(this->conn, data, length) == (int) length
+                && mg_write(this->conn, "\r\n", 2) == 2;
+    }
+
+    bool HttpResponseStream::Deflate(const char* data, size_t length,
+            int flush)
+    {
+        this->stream.next_in = (Bytef*) data;
+        this->stream.avail_in = length;
+        int result = Z_OK;
+
+        //deflate is called until it consumed all input and has no more output pending.
+        do
+        {
+            this->stream.next_out = (Bytef*) &this->output[0];
+            this->stream.avail_out = this->output.size();
+            result = deflate(&this->stream, flush);
+            if (result == Z_STREAM_ERROR)
+            {
+                return false;
+            }
+
+            size_t available = this->output.size() - this->stream.avail_out;
+            if (available > 0 && !this->WriteChunk(&this->output[0], available))
+            {
+                return false;
+            }
+        } while (this->stream.avail_out == 0
+                || (flush == Z_FINISH && result != Z_STREAM_END));
+
+        return true;
+    }
+
+} /* namespace jsonrpc */
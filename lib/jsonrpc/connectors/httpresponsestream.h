@@ -0,0 +1,59 @@
+/**
+ * @file httpresponsestream.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Sends a HTTP response in pieces, using chunked transfer encoding.
+ */
+
+#ifndef HTTPRESPONSESTREAM_H_
+#define HTTPRESPONSESTREAM_H_
+
+#include <vector>
+#include <zlib.h>
+#include <mongoose/mongoose.h>
+#include "../responsestream.h"
+
+namespace jsonrpc
+{
+    /**
+     * Content codings the HttpServer is able to produce.
+     */
+    typedef enum
+    {
+        ENCODING_IDENTITY, ENCODING_GZIP, ENCODING_DEFLATE
+    } contentencoding_t;
+
+    /**
+     * This stream writes a HTTP/1.1 response with chunked transfer encoding to a mongoose connection.
+     * If an encoding other than ENCODING_IDENTITY is given, the data is compressed with zlib on the fly
+     * and a chunk is sent whenever enough compressed output is available.
+     */
+    class HttpResponseStream: public ResponseStream
+    {
+        public:
+            /**
+             * @param conn - the connection of the current request.
+             * @param encoding - the content coding, which has been negotiated with the client.
+             * @param level - zlib compression level, ignored for ENCODING_IDENTITY.
+             */
+            HttpResponseStream(struct mg_connection* conn, contentencoding_t encoding, int level);
+            virtual ~HttpResponseStream();
+
+            virtual bool Begin();
+            virtual bool Write(const char* data, size_t length);
+            virtual bool End();
+
+        private:
+            bool WriteChunk(const char* data, size_t length);
+            bool Deflate(const char* data, size_t length, int flush);
+
+            struct mg_connection* conn;
+            contentencoding_t encoding;
+            int level;
+            z_stream stream;
+            bool compressing;
+            std::vector<char> output;
+    };
+
+} /* namespace jsonrpc */
+#endif /* HTTPRESPONSESTREAM_H_ */
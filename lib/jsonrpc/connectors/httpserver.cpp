@@ -6,17 +6,243 @@
  */
 
 #include "httpserver.h"
+#include "httpresponsestream.h"
+#include "../requestparser.h"
+#include "../tracer.h"
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
+#include <cctype>
+#include <vector>
+#include <sstream>
+#include <pthread.h>
+
+/**
+ * Request buffers keep their memory between requests, unless a request was bigger than this.
+ */
+#define MAX_POOLED_BUFFER_SIZE (1024 * 1024)
+
+/**
+ * Bodies of at least this size are parsed while they are received, in pieces of this size.
+ */
+#define INCREMENTAL_PARSE_SIZE (64 * 1024)
 
 namespace jsonrpc
 {
+    static pthread_key_t bufferKey;
+    static pthread_once_t bufferKeyOnce = PTHREAD_ONCE_INIT;
+
+    static void deleteRequestBuffer(void* buffer)
+    {
+        delete (std::vector<char>*) buffer;
+    }
+
+    static void createBufferKey()
+    {
+        pthread_key_create(&bufferKey, &deleteRequestBuffer);
+    }
+
+    /**
+     * Each mongoose worker thread gets its own request buffer, which is reused for all requests of this thread.
+     */
+    static std::vector<char>& getRequestBuffer()
+    {
+        pthread_once(&bufferKeyOnce, &createBufferKey);
+        std::vector<char>* buffer = (std::vector<char>*) pthread_getspecific(bufferKey);
+        if (buffer == NULL)
+        {
+            buffer = new std::vector<char>();
+            pthread_setspecific(bufferKey, buffer);
+        }
+        return *buffer;
+    }
+
+    /**
+     * Reads the request body into the pooled buffer of the calling thread.
+     * @return false if the body could not be read completely.
+     */
+    static bool readRequestBody(struct mg_connection *conn, std::vector<char>& buffer, size_t length)
+    {
+        buffer.resize(length);
+        size_t pos = 0;
+        while (pos < length)
+        {
+            int n = mg_read(conn, &buffer[pos], length - pos);
+            if (n <= 0)
+            {
+                return false;
+            }
+            pos += n;
+        }
+        return true;
+    }
+
+    /**
+     * Receives a big body piece by piece and hands each piece to the parser right away, so parsing
+     * of batch elements overlaps with receiving the rest of the body.
+     * Stops early if the body is already known to be invalid, the rest is not needed then. mongoose closes the
+     * connection after each request (keep-alive is not enabled), so the unread part is simply discarded.
+     * @return false if the connection broke before the body was read.
+     */
+    static bool parseRequestBody(struct mg_connection *conn, RequestParser& parser, size_t length)
+    {
+        size_t pos = 0;
+        while (pos < length)
+        {
+            size_t size = length - pos;
+            if (size > INCREMENTAL_PARSE_SIZE)
+            {
+                size = INCREMENTAL_PARSE_SIZE;
+            }
+            int n = mg_read(conn, parser.GetBuffer(size), size);
+            if (n <= 0)
+            {
+                return false;
+            }
+            pos += n;
+            if (!parser.Commit(n))
+            {
+                break;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Checks whether the given Accept-Encoding header allows the encoding, i.e. names it without q=0.
+     */
+    static bool acceptsEncoding(const char* header, const char* encoding)
+    {
+        size_t encodingLength = strlen(encoding);
+        const char* pos = header;
+        while (*pos != '\0')
+        {
+            while (*pos == ' ' || *pos == ',')
+            {
+                pos++;
+            }
+            const char* end = pos;
+            while (*end != '\0' && *end != ',' && *end != ';' && *end != ' ')
+            {
+                end++;
+            }
+            bool match = (size_t) (end - pos) == encodingLength;
+            for (size_t i = 0; match && i < encodingLength; i++)
+            {
+                match = tolower(pos[i]) == encoding[i];
+            }
+
+            //parameters of this entry, we are only interested in q=0
+            double quality = 1.0;
+            while (*end != '\0' && *end != ',')
+            {
+                if (*end == 'q' && *(end + 1) == '=')
+                {
+                    quality = strtod(end + 2, NULL);
+                }
+                end++;
+            }
+            if (match)
+            {
+                return quality > 0;
+            }
+            pos = end;
+        }
+        return false;
+    }
+
+    /**
+     * @return the content coding to use for the response of the current request.
+     */
+    static contentencoding_t negotiateEncoding(struct mg_connection *conn)
+    {
+        const char* acceptEncoding = mg_get_header(conn, "Accept-Encoding");
+        if (acceptEncoding != NULL)
+        {
+            if (acceptsEncoding(acceptEncoding, "gzip"))
+            {
+                return ENCODING_GZIP;
+            }
+            else if (acceptsEncoding(acceptEncoding, "deflate"))
+            {
+                return ENCODING_DEFLATE;
+            }
+        }
+        return ENCODING_IDENTITY;
+    }
+
+    /**
+     * chunked transfer encoding requires HTTP/1.1
+     */
+    static bool supportsChunks(struct mg_connection *conn)
+    {
+        return strcmp(mg_get_request_info(conn)->http_version, "1.1") == 0;
+    }
+
+    /**
+     * Escapes a label value for the text exposition format.
+     */
+    static std::string escapeLabel(const std::string& value)
+    {
+        std::string result;
+        for (size_t i = 0; i < value.length(); i++)
+        {
+            switch (value[i])
+            {
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                default:
+                    result += value[i];
+            }
+        }
+        return result;
+    }
+
+    static void writeHeader(std::ostream& out, const char* name,
+            const char* type, const char* help)
+    {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+    }
+
+    /**
+     * Writes the latency histograms as summaries, with the given labels (e.g. method="...",) in front of the phase.
+     */
+    static void writeLatencies(std::ostream& out, const char* name,
+            const std::string& labels, const CallMetrics& metrics)
+    {
+        static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+        for (int phase = 0; phase < PHASE_COUNT; phase++)
+        {
+            const LatencyHistogram& histogram = metrics.GetHistogram(
+                    (phase_t) phase);
+            std::string phaseLabels = labels + "phase=\""
+                    + CallMetrics::GetPhaseName((phase_t) phase) + "\"";
+            for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]);
+                    i++)
+            {
+                out << name << "{" << phaseLabels << ",quantile=\""
+                        << quantiles[i] << "\"} "
+                        << histogram.GetValueAtQuantile(quantiles[i]) / 1e9
+                        << "\n";
+            }
+            out << name << "_sum{" << phaseLabels << "} "
+                    << histogram.GetTotal() / 1e9 << "\n";
+            out << name << "_count{" << phaseLabels << "} "
+                    << histogram.GetCount() << "\n";
+        }
+    }
+
     static void *callback(enum mg_event event, struct mg_connection *conn)
     {
         const struct mg_request_info *request_info = mg_get_request_info(conn);
-        char* readBuffer = NULL;
-        int postSize = 0;
 
         HttpServer* _this = (HttpServer*) request_info->user_data;
 
@@ -25,18 +251,17 @@ namespace jsonrpc
 
             if (strcmp(request_info->request_method, "GET") == 0)
             {
+                if (strcmp(request_info->uri, HTTP_METRICS_PATH) == 0)
+                {
+                    _this->OnMetricsRequest(conn);
+                    return (void*) "";
+                }
                 //Mark the request as unprocessed.
                 return NULL;
             }
             else if (strcmp(request_info->request_method, "POST") == 0)
             {
-                //get size of postData
-                sscanf(mg_get_header(conn, "Content-Length"), "%d", &postSize);
-                readBuffer = (char*) malloc(sizeof(char) * (postSize + 1));
-                mg_read(conn, readBuffer, postSize);
-                _this->OnRequest(readBuffer, conn);
-                free(readBuffer);
-
+                _this->OnPostRequest(conn);
                 //Mark the request as processed by our handler.
                 return (void*) "";
             }
@@ -45,13 +270,22 @@ namespace jsonrpc
                 return NULL;
             }
         }
+        else if (event == MG_WEBSOCKET_CONNECT || event == MG_WEBSOCKET_READY
+                || event == MG_WEBSOCKET_MESSAGE || event == MG_WEBSOCKET_CLOSE)
+        {
+            return _this->OnWebSocketEvent(event, conn);
+        }
         else
         {
             return NULL;
         }
     }
 
-    HttpServer::HttpServer(int port) : port(port), resPath("")
+    HttpServer::HttpServer(int port)
+            : port(port), ctx(NULL), resPath(""), compressionThreshold(
+                    HTTP_DEFAULT_COMPRESSION_THRESHOLD), compressionLevel(
+                    Z_BEST_SPEED), maxRequestSize(HTTP_UNLIMITED_REQUEST_SIZE), requests(
+                    0), inFlight(0)
     {
     }
 
@@ -61,6 +295,11 @@ namespace jsonrpc
         this->port = port;
         this->ctx = NULL;
         this->resPath = getResourcePath;
+        this->compressionThreshold = HTTP_DEFAULT_COMPRESSION_THRESHOLD;
+        this->compressionLevel = Z_BEST_SPEED;
+        this->maxRequestSize = HTTP_UNLIMITED_REQUEST_SIZE;
+        this->requests = 0;
+        this->inFlight = 0;
     }
 
     HttpServer::~HttpServer()
@@ -101,14 +340,215 @@ namespace jsonrpc
         return true;
     }
     
+    void HttpServer::OnPostRequest(struct mg_connection* conn)
+    {
+        __sync_fetch_and_add(&this->requests, 1);
+        if (Tracer::IsEnabled())
+        {
+            //the connection has been waiting for this worker thread since it was accepted
+            uint64_t now = Tracer::Now();
+            Tracer::Record("queue",
+                    now - Tracer::FromNanoseconds(
+                            mg_get_request_info(conn)->queue_time), now);
+        }
+        TraceSpan span("request");
+
+        //get size of postData
+        const char* contentLength = mg_get_header(conn, "Content-Length");
+        if (contentLength == NULL)
+        {
+            mg_printf(conn, "HTTP/1.1 411 Length Required\r\n"
+                    "Content-Length: 0\r\n\r\n");
+            return;
+        }
+        size_t postSize = strtoul(contentLength, NULL, 10);
+        if (postSize > this->maxRequestSize)
+        {
+            mg_printf(conn, "HTTP/1.1 413 Request Entity Too Large\r\n"
+                    "Content-Length: 0\r\n\r\n");
+            return;
+        }
+
+        __sync_fetch_and_add(&this->inFlight, 1);
+        if (postSize >= INCREMENTAL_PARSE_SIZE)
+        {
+            RequestParser parser;
+            Json::Value request;
+            bool received;
+            {
+                //parsing of batch elements overlaps with reading here
+                TraceSpan span("read+parse");
+                received = parseRequestBody(conn, parser, postSize);
+            }
+            if (received)
+            {
+                if (parser.Finish(request))
+                {
+                    this->OnParsedRequest(&request, conn);
+                }
+                else
+                {
+                    this->OnParsedRequest(NULL, conn);
+                }
+            }
+        }
+        else
+        {
+            std::vector<char>& buffer = getRequestBuffer();
+            bool received;
+            {
+                TraceSpan span("read");
+                received = readRequestBody(conn, buffer, postSize);
+            }
+            if (received)
+            {
+                this->OnRequest(postSize > 0 ? &buffer[0] : "", postSize, conn);
+            }
+            if (buffer.capacity() > MAX_POOLED_BUFFER_SIZE)
+            {
+                std::vector<char>().swap(buffer);
+            }
+        }
+        __sync_fetch_and_sub(&this->inFlight, 1);
+    }
+
+    void HttpServer::OnMetricsRequest(struct mg_connection* conn)
+    {
+        std::ostringstream out;
+        struct mg_stats stats;
+        mg_get_stats(this->ctx, &stats);
+
+        writeHeader(out, "jsonrpc_http_requests_total", "counter",
+                "HTTP POST requests received.");
+        out << "jsonrpc_http_requests_total " << this->requests << "\n";
+        writeHeader(out, "jsonrpc_http_requests_in_flight", "gauge",
+                "HTTP POST requests currently being processed.");
+        out << "jsonrpc_http_requests_in_flight " << this->inFlight << "\n";
+        writeHeader(out, "jsonrpc_http_queued_connections", "gauge",
+                "Accepted connections waiting for a worker thread.");
+        out << "jsonrpc_http_queued_connections " << stats.queued_connections
+                << "\n";
+        writeHeader(out, "jsonrpc_http_worker_threads", "gauge",
+                "Worker threads of the HTTP server.");
+        out << "jsonrpc_http_worker_threads " << stats.num_threads << "\n";
+        writeHeader(out, "jsonrpc_http_worker_utilization", "gauge",
+                "Fraction of worker threads currently serving a connection.");
+        out << "jsonrpc_http_worker_utilization "
+                << (stats.num_threads > 0 ?
+                        (double) stats.busy_threads / stats.num_threads : 0.0)
+                << "\n";
+        writeHeader(out, "jsonrpc_http_received_bytes_total", "counter",
+                "Bytes received from clients.");
+        out << "jsonrpc_http_received_bytes_total " << stats.bytes_received
+                << "\n";
+        writeHeader(out, "jsonrpc_http_sent_bytes_total", "counter",
+                "Bytes sent to clients.");
+        out << "jsonrpc_http_sent_bytes_total " << stats.bytes_sent << "\n";
+
+        RequestHandler* handler = this->GetHandler();
+        if (handler != NULL)
+        {
+            const CallMetrics& metrics = handler->GetMetrics();
+            ProcedureRegistry::ReadSection section(
+                    handler->GetProcedureRegistry());
+            const procedurelist_t& procedures = handler->GetProcedures();
+
+            writeHeader(out, "jsonrpc_calls_total", "counter",
+                    "JSON-RPC calls, each element of a batch counts.");
+            out << "jsonrpc_calls_total " << metrics.GetCalls() << "\n";
+            writeHeader(out, "jsonrpc_errors_total", "counter",
+                    "JSON-RPC error responses.");
+            out << "jsonrpc_errors_total " << metrics.GetErrors() << "\n";
+            writeHeader(out, "jsonrpc_phase_seconds", "summary",
+                    "Latency of the processing phases of all requests.");
+            writeLatencies(out, "jsonrpc_phase_seconds", "", metrics);
+
+            writeHeader(out, "jsonrpc_cache_hits_total", "counter",
+                    "Calls answered from the response cache.");
+            out << "jsonrpc_cache_hits_total "
+                    << handler->GetResponseCache().GetHits() << "\n";
+            writeHeader(out, "jsonrpc_cache_misses_total", "counter",
+                    "Calls of cached methods which had to be executed.");
+            out << "jsonrpc_cache_misses_total "
+                    << handler->GetResponseCache().GetMisses() << "\n";
+
+            writeHeader(out, "jsonrpc_method_calls_total", "counter",
+                    "JSON-RPC calls per procedure.");
+            for (procedurelist_t::const_iterator it = procedures.begin();
+                    it != procedures.end(); it++)
+            {
+                out << "jsonrpc_method_calls_total{method=\""
+                        << escapeLabel(it->first) << "\"} "
+                        << it->second->GetMetrics().GetCalls() << "\n";
+            }
+            writeHeader(out, "jsonrpc_method_errors_total", "counter",
+                    "JSON-RPC error responses per procedure.");
+            for (procedurelist_t::const_iterator it = procedures.begin();
+                    it != procedures.end(); it++)
+            {
+                out << "jsonrpc_method_errors_total{method=\""
+                        << escapeLabel(it->first) << "\"} "
+                        << it->second->GetMetrics().GetErrors() << "\n";
+            }
+            writeHeader(out, "jsonrpc_method_phase_seconds", "summary",
+                    "Latency of the processing phases per procedure.");
+            for (procedurelist_t::const_iterator it = procedures.begin();
+                    it != procedures.end(); it++)
+            {
+                writeLatencies(out, "jsonrpc_method_phase_seconds",
+                        "method=\"" + escapeLabel(it->first) + "\",",
+                        it->second->GetMetrics());
+            }
+        }
+
+        std::string text = out.str();
+        mg_printf(conn, "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4\r\n"
+                "Content-Length: %lu\r\n\r\n", (unsigned long) text.length());
+        mg_write(conn, text.data(), text.length());
+    }
+
+    void* HttpServer::OnWebSocketEvent(enum mg_event event,
+            struct mg_connection* conn)
+    {
+        if (event == MG_WEBSOCKET_CONNECT)
+        {
+            //Refuse the handshake, plain HTTP connectors only accept POST requests.
+            return (void*) "";
+        }
+        return NULL;
+    }
+
     bool HttpServer::SendResponse(const std::string& response, void* addInfo)
     {
         struct mg_connection* conn = (struct mg_connection*) addInfo;
-        if (mg_printf(conn, "HTTP/1.1 200 OK\r\n"
+        char header[128];
+
+        if (response.length() >= this->compressionThreshold
+                && supportsChunks(conn))
+        {
+            contentencoding_t encoding = negotiateEncoding(conn);
+            if (encoding != ENCODING_IDENTITY)
+            {
+                //The response is compressed piece by piece, each piece is sent as soon as it is ready.
+                HttpResponseStream stream(conn, encoding,
+                        this->compressionLevel);
+                return stream.Begin()
+                        && stream.Write(response.data(), response.length())
+                        && stream.End();
+            }
+        }
+
+        //Only the header is formatted, the body is written directly out of the response string.
+        int headerLength = snprintf(header, sizeof(header),
+                "HTTP/1.1 200 OK\r\n"
                 "Content-Type: text/plain\r\n"
-                "Content-Length: %d\r\n"
-                "\r\n"
-                "%s",(int)response.length(), response.c_str()) > 0)
+                "Content-Length: %lu\r\n"
+                "\r\n", (unsigned long) response.length());
+
+        if (mg_write(conn, header, headerLength) == headerLength
+                && mg_write(conn, response.data(), response.length())
+                        == (int) response.length())
         {
             return true;
         }
@@ -118,4 +558,40 @@ namespace jsonrpc
         }
     }
 
+    void HttpServer::SetCompressionThreshold(size_t threshold)
+    {
+        this->compressionThreshold = threshold;
+    }
+
+    void HttpServer::SetCompressionLevel(int level)
+    {
+        this->compressionLevel = level;
+    }
+
+    void HttpServer::SetMaxRequestSize(size_t size)
+    {
+        this->maxRequestSize = size;
+    }
+
+    size_t HttpServer::GetMaxRequestSize() const
+    {
+        return this->maxRequestSize;
+    }
+
+    ResponseStream* HttpServer::CreateResponseStream(void* addInfo)
+    {
+        struct mg_connection* conn = (struct mg_connection*) addInfo;
+        if (!supportsChunks(conn))
+        {
+            return NULL;
+        }
+        //The size of a streamed result is unknown, so the threshold does not apply.
+        contentencoding_t encoding = ENCODING_IDENTITY;
+        if (this->compressionThreshold != HTTP_NO_COMPRESSION)
+        {
+            encoding = negotiateEncoding(conn);
+        }
+        return new HttpResponseStream(conn, encoding, this->compressionLevel);
+    }
+
 } /* namespace jsonrpc */
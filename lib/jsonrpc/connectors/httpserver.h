@@ -11,6 +11,26 @@
 #include <mongoose/mongoose.h>
 #include "../serverconnector.h"
 
+/**
+ * Responses smaller than this (in bytes) are sent uncompressed by default.
+ */
+#define HTTP_DEFAULT_COMPRESSION_THRESHOLD 1024
+
+/**
+ * Pass this to HttpServer::SetCompressionThreshold to switch off compression entirely.
+ */
+#define HTTP_NO_COMPRESSION ((size_t) -1)
+
+/**
+ * Pass this to HttpServer::SetMaxRequestSize to accept requests of any size (default).
+ */
+#define HTTP_UNLIMITED_REQUEST_SIZE ((size_t) -1)
+
+/**
+ * GET requests to this path are answered with the metrics of the server in the Prometheus text exposition format.
+ */
+#define HTTP_METRICS_PATH "/metrics"
+
 namespace jsonrpc
 {
     /**
@@ -47,10 +67,58 @@ namespace jsonrpc
             bool virtual SendResponse(const std::string& response,
                     void* addInfo = NULL);
 
+            /**
+             * Results of streaming methods are sent with chunked transfer encoding (HTTP/1.1 requests only).
+             */
+            virtual ResponseStream* CreateResponseStream(void* addInfo);
+
+            /**
+             * This method is called by the mongoose callback for all POST requests, it reads the body and handles the request.
+             */
+            virtual void OnPostRequest(struct mg_connection* conn);
+
+            /**
+             * This method is called by the mongoose callback for GET requests to HTTP_METRICS_PATH.
+             * It reports request counters, in-flight requests, the accept queue depth, worker utilization, bytes in/out
+             * and the latency quantiles of all procedures. Everything is read from lock free counters.
+             */
+            virtual void OnMetricsRequest(struct mg_connection* conn);
+
+            /**
+             * This method is called by the mongoose callback for all MG_WEBSOCKET_* events.
+             * The return value is handed back to mongoose. This implementation refuses all websocket handshakes.
+             */
+            virtual void* OnWebSocketEvent(enum mg_event event, struct mg_connection* conn);
+
+            /**
+             * Responses of at least this size (in bytes) are compressed with gzip or deflate, if the client
+             * announced support for it in its Accept-Encoding header. The compressed body is streamed with chunked transfer encoding.
+             * Streamed results are compressed regardless of their size, unless compression is switched off.
+             * @param threshold - minimum response size to compress, HTTP_NO_COMPRESSION switches compression off.
+             */
+            void SetCompressionThreshold(size_t threshold);
+
+            /**
+             * @param level - zlib compression level from 1 (fastest, default) to 9 (best).
+             */
+            void SetCompressionLevel(int level);
+
+            /**
+             * Requests with a bigger body are answered with 413 Request Entity Too Large, without reading the body.
+             * @param size - maximum body size in bytes, HTTP_UNLIMITED_REQUEST_SIZE (default) accepts any size.
+             */
+            void SetMaxRequestSize(size_t size);
+            size_t GetMaxRequestSize() const;
+
         private:
             int port;
             struct mg_context *ctx;
             std::string resPath;
+            size_t compressionThreshold;
+            int compressionLevel;
+            size_t maxRequestSize;
+            volatile uint64_t requests;
+            volatile int inFlight;
     };
 
 } /* namespace jsonrpc */
@@ -0,0 +1,44 @@
+/**
+ * @file loopbackclient.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ClientConnector calling a LoopbackServer inside the same process.
+ */
+
+#include "loopbackclient.h"
+
+using namespace std;
+
+namespace jsonrpc
+{
+    LoopbackClient::LoopbackClient(LoopbackServer* server)
+            : server(server)
+    {
+    }
+
+    LoopbackClient::~LoopbackClient()
+    {
+    }
+
+    std::string LoopbackClient::SendMessage(const std::string& message) throw (Exception)
+    {
+        string result;
+        if (!this->server->IsListening()
+                || !this->server->OnRequest(message, &result))
+        {
+            throw Exception(ERROR_CLIENT_CONNECT, "loopback server is not listening");
+        }
+        return result;
+    }
+
+    void LoopbackClient::SendRequest(const Json::Value& request,
+            Json::Value& response) throw (Exception)
+    {
+        if (!this->server->IsListening()
+                || !this->server->OnRequest(request, response))
+        {
+            throw Exception(ERROR_CLIENT_CONNECT, "loopback server is not listening");
+        }
+    }
+
+} /* namespace jsonrpc */
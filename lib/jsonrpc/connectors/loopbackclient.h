@@ -0,0 +1,36 @@
+/**
+ * @file loopbackclient.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ClientConnector calling a LoopbackServer inside the same process.
+ */
+
+#ifndef LOOPBACKCLIENT_H_
+#define LOOPBACKCLIENT_H_
+
+#include "../clientconnector.h"
+#include "../exception.h"
+#include "loopbackserver.h"
+
+namespace jsonrpc
+{
+    /**
+     * This connector hands requests directly to the RequestHandler behind a LoopbackServer.
+     * Requests sent by Client are passed as Json::Value and are never serialized or parsed.
+     * The server connector is not owned by this class, it is still deleted by its Server.
+     */
+    class LoopbackClient : public ClientConnector
+    {
+        public:
+            LoopbackClient(LoopbackServer* server);
+            virtual ~LoopbackClient();
+
+            virtual std::string SendMessage(const std::string& message) throw (Exception);
+            virtual void SendRequest(const Json::Value& request, Json::Value& response) throw (Exception);
+
+        private:
+            LoopbackServer* server;
+    };
+
+} /* namespace jsonrpc */
+#endif /* LOOPBACKCLIENT_H_ */
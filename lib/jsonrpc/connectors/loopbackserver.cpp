@@ -0,0 +1,44 @@
+/**
+ * @file loopbackserver.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ServerConnector for calls from inside the same process.
+ */
+
+#include "loopbackserver.h"
+
+namespace jsonrpc
+{
+    LoopbackServer::LoopbackServer()
+            : ServerConnector(), listening(false)
+    {
+    }
+
+    LoopbackServer::~LoopbackServer()
+    {
+    }
+
+    bool LoopbackServer::StartListening()
+    {
+        this->listening = true;
+        return true;
+    }
+
+    bool LoopbackServer::StopListening()
+    {
+        this->listening = false;
+        return true;
+    }
+
+    bool LoopbackServer::SendResponse(const std::string& response,
+            void* addInfo)
+    {
+        if (addInfo == NULL)
+        {
+            return false;
+        }
+        *((std::string*) addInfo) = response;
+        return true;
+    }
+
+} /* namespace jsonrpc */
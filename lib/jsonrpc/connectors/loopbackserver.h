@@ -0,0 +1,44 @@
+/**
+ * @file loopbackserver.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ServerConnector for calls from inside the same process.
+ */
+
+#ifndef LOOPBACKSERVER_H_
+#define LOOPBACKSERVER_H_
+
+#include "../serverconnector.h"
+
+namespace jsonrpc
+{
+    /**
+     * This connector does not listen anywhere, it is only the endpoint for one or more LoopbackClient instances.
+     * Requests are processed synchronously in the calling thread.
+     */
+    class LoopbackServer: public ServerConnector
+    {
+        public:
+            LoopbackServer();
+            virtual ~LoopbackServer();
+
+            virtual bool StartListening();
+            virtual bool StopListening();
+
+            /**
+             * @param addInfo - must point to the std::string which receives the response.
+             */
+            bool virtual SendResponse(const std::string& response,
+                    void* addInfo = NULL);
+
+            bool IsListening() const
+            {
+                return listening;
+            }
+
+        private:
+            bool listening;
+    };
+
+} /* namespace jsonrpc */
+#endif /* LOOPBACKSERVER_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @file sharedmemoryclient.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ClientConnector attaching to the shared memory region of a SharedMemoryServer.
+ */
+
+#include "sharedmemoryclient.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace jsonrpc
+{
+    SharedMemoryClient::SharedMemoryClient(const std::string& name) throw (Exception)
+            : region(NULL), size(0)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+        {
+            throw Exception(ERROR_CLIENT_CONNECT, "shared memory region " + name + " does not exist");
+        }
+
+        struct stat st;
+        void* mem = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(shm_region_t))
+        {
+            this->size = st.st_size;
+            mem = mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+
+        if (mem == MAP_FAILED)
+        {
+            throw Exception(ERROR_CLIENT_CONNECT, "could not map shared memory region " + name);
+        }
+
+        this->region = (shm_region_t*) mem;
+        if (this->region->magic != SHM_MAGIC
+                || SharedMemoryRing::GetRegionSize(this->region->capacity) != this->size)
+        {
+            munmap(mem, this->size);
+            throw Exception(ERROR_CLIENT_CONNECT, "invalid shared memory region " + name);
+        }
+        __sync_synchronize();
+
+        char* data = (char*) mem + sizeof(shm_region_t);
+        this->requests.Attach(this->region, &this->region->requests, data);
+        this->responses.Attach(this->region, &this->region->responses,
+                data + this->region->capacity);
+
+        pthread_mutex_init(&this->lock, NULL);
+    }
+
+    SharedMemoryClient::~SharedMemoryClient()
+    {
+        pthread_mutex_destroy(&this->lock);
+        munmap(this->region, this->size);
+    }
+
+    std::string SharedMemoryClient::SendMessage(const std::string& message) throw (Exception)
+    {
+        string result;
+
+        pthread_mutex_lock(&this->lock);
+        bool ok = this->requests.WriteFrame(message)
+                && this->responses.ReadFrame(result);
+        pthread_mutex_unlock(&this->lock);
+
+        if (!ok)
+        {
+            throw Exception(ERROR_CLIENT_CONNECT, "shared memory region has been closed by the server");
+        }
+        return result;
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,43 @@
+/**
+ * @file sharedmemoryclient.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ClientConnector attaching to the shared memory region of a SharedMemoryServer.
+ */
+
+#ifndef SHAREDMEMORYCLIENT_H_
+#define SHAREDMEMORYCLIENT_H_
+
+#include <pthread.h>
+#include "../clientconnector.h"
+#include "../exception.h"
+#include "sharedmemoryring.h"
+
+namespace jsonrpc
+{
+    /**
+     * This class attaches to a region created by SharedMemoryServer. Calls from different threads of
+     * the same process are serialized, calls from different processes are not supported on the same region.
+     */
+    class SharedMemoryClient : public ClientConnector
+    {
+        public:
+            /**
+             * @param name - name of the shared memory object, the server must already be listening on it.
+             * @throws Exception with ERROR_CLIENT_CONNECT if the region could not be attached.
+             */
+            SharedMemoryClient(const std::string& name) throw (Exception);
+            virtual ~SharedMemoryClient();
+
+            virtual std::string SendMessage(const std::string& message) throw (Exception);
+
+        private:
+            shm_region_t* region;
+            size_t size;
+            SharedMemoryRing requests;
+            SharedMemoryRing responses;
+            pthread_mutex_t lock;
+    };
+
+} /* namespace jsonrpc */
+#endif /* SHAREDMEMORYCLIENT_H_ */
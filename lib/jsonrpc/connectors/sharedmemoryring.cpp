@@ -0,0 +1,218 @@
+/**
+ * @file sharedmemoryring.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Lock-free single producer / single consumer byte ring living in a shared memory region.
+ */
+
+#include "sharedmemoryring.h"
+#include <cstring>
+#include <climits>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+#include <unistd.h>
+
+/**
+ * Number of polls, before a waiting side goes to sleep.
+ */
+#define SHM_SPIN_COUNT 2000
+
+/**
+ * Upper bound for one sleep in microseconds, so a closed region is recognised in time.
+ */
+#define SHM_WAIT_TIMEOUT 100000
+
+namespace jsonrpc
+{
+    /**
+     * Sleeps as long as *addr equals value. Spurious wakeups are fine, callers check their condition again.
+     */
+    static void waitWhileEqual(volatile uint32_t* addr, uint32_t value,
+            volatile uint32_t* waiters)
+    {
+        for (int i = 0; i < SHM_SPIN_COUNT; i++)
+        {
+            if (*addr != value)
+            {
+                return;
+            }
+        }
+
+        __sync_fetch_and_add(waiters, 1);
+        if (*addr == value)
+        {
+#ifdef __linux__
+            struct timespec timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_nsec = SHM_WAIT_TIMEOUT * 1000;
+            syscall(SYS_futex, addr, FUTEX_WAIT, value, &timeout, NULL, 0);
+#else
+            usleep(50);
+#endif
+        }
+        __sync_fetch_and_sub(waiters, 1);
+    }
+
+    static void wake(volatile uint32_t* addr, volatile uint32_t* waiters)
+    {
+        //Pairs with the increment of waiters in waitWhileEqual
+        __sync_synchronize();
+        if (*waiters > 0)
+        {
+#ifdef __linux__
+            syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+        }
+    }
+
+    SharedMemoryRing::SharedMemoryRing()
+            : region(NULL), header(NULL), data(NULL), mask(0)
+    {
+    }
+
+    void SharedMemoryRing::Attach(shm_region_t* region,
+            shm_ringheader_t* header, char* data)
+    {
+        this->region = region;
+        this->header = header;
+        this->data = data;
+        this->mask = region->capacity - 1;
+    }
+
+    bool SharedMemoryRing::WriteFrame(const std::string& frame)
+    {
+        uint32_t length = frame.length();
+        return this->Write((const char*) &length, sizeof(length))
+                && this->Write(frame.data(), length);
+    }
+
+    bool SharedMemoryRing::ReadFrame(std::string& frame)
+    {
+        uint32_t length;
+        if (!this->Read((char*) &length, sizeof(length)))
+        {
+            return false;
+        }
+        frame.resize(length);
+        if (length == 0)
+        {
+            return true;
+        }
+        return this->Read(&frame[0], length);
+    }
+
+    void SharedMemoryRing::WakeAll()
+    {
+        if (this->header != NULL)
+        {
+            __sync_synchronize();
+#ifdef __linux__
+            syscall(SYS_futex, &this->header->head, FUTEX_WAKE, INT_MAX, NULL,
+                    NULL, 0);
+            syscall(SYS_futex, &this->header->tail, FUTEX_WAKE, INT_MAX, NULL,
+                    NULL, 0);
+#endif
+        }
+    }
+
+    size_t SharedMemoryRing::GetRegionSize(uint32_t capacity)
+    {
+        return sizeof(shm_region_t) + 2 * (size_t) capacity;
+    }
+
+    uint32_t SharedMemoryRing::NormalizeCapacity(size_t capacity)
+    {
+        uint32_t result = 64;
+        while (result < capacity && result < (1u << 31))
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    bool SharedMemoryRing::Write(const char* data, uint32_t length)
+    {
+        uint32_t capacity = this->mask + 1;
+        while (length > 0)
+        {
+            uint32_t head = this->header->head;
+            uint32_t tail = this->header->tail;
+            uint32_t space = capacity - (head - tail);
+            if (space == 0)
+            {
+                if (this->region->closed)
+                {
+                    return false;
+                }
+                waitWhileEqual(&this->header->tail, tail,
+                        &this->header->tailWaiters);
+                continue;
+            }
+
+            uint32_t chunk = length < space ? length : space;
+            uint32_t offset = head & this->mask;
+            uint32_t first = capacity - offset;
+            if (first > chunk)
+            {
+                first = chunk;
+            }
+            memcpy(this->data + offset, data, first);
+            memcpy(this->data, data + first, chunk - first);
+
+            //payload must be visible before the new head
+            __sync_synchronize();
+            this->header->head = head + chunk;
+            wake(&this->header->head, &this->header->headWaiters);
+
+            data += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+
+    bool SharedMemoryRing::Read(char* data, uint32_t length)
+    {
+        uint32_t capacity = this->mask + 1;
+        while (length > 0)
+        {
+            uint32_t tail = this->header->tail;
+            uint32_t head = this->header->head;
+            uint32_t available = head - tail;
+            if (available == 0)
+            {
+                if (this->region->closed)
+                {
+                    return false;
+                }
+                waitWhileEqual(&this->header->head, head,
+                        &this->header->headWaiters);
+                continue;
+            }
+            //don't read the payload before the head that published it
+            __sync_synchronize();
+
+            uint32_t chunk = length < available ? length : available;
+            uint32_t offset = tail & this->mask;
+            uint32_t first = capacity - offset;
+            if (first > chunk)
+            {
+                first = chunk;
+            }
+            memcpy(data, this->data + offset, first);
+            memcpy(data + first, this->data, chunk - first);
+
+            __sync_synchronize();
+            this->header->tail = tail + chunk;
+            wake(&this->header->tail, &this->header->tailWaiters);
+
+            data += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+
+} /* namespace jsonrpc */
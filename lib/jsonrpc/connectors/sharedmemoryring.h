@@ -0,0 +1,105 @@
+/**
+ * @file sharedmemoryring.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Lock-free single producer / single consumer byte ring living in a shared memory region.
+ */
+
+#ifndef SHAREDMEMORYRING_H_
+#define SHAREDMEMORYRING_H_
+
+#include <string>
+#include <stdint.h>
+
+/**
+ * Marks a region as initialized by a SharedMemoryServer ("JRPC").
+ */
+#define SHM_MAGIC 0x4a525043
+
+/**
+ * Default capacity in bytes of each direction of a shared memory region.
+ */
+#define SHM_DEFAULT_CAPACITY (1 << 20)
+
+namespace jsonrpc
+{
+    /**
+     * Control block of one ring direction. Producer and consumer indices are kept
+     * on separate cache lines, so both sides don't invalidate each other on every frame.
+     * The indices are free running byte counters, the capacity must be a power of two.
+     */
+    struct shm_ringheader_t
+    {
+            volatile uint32_t head;
+            volatile uint32_t headWaiters;
+            char padding1[56];
+            volatile uint32_t tail;
+            volatile uint32_t tailWaiters;
+            char padding2[56];
+    };
+
+    /**
+     * Layout of the whole memory mapped region: one ring for requests (client -> server)
+     * and one ring for responses (server -> client), followed by the data areas of both rings.
+     */
+    struct shm_region_t
+    {
+            uint32_t magic;
+            uint32_t capacity;
+            volatile uint32_t closed;
+            char padding[52];
+            shm_ringheader_t requests;
+            shm_ringheader_t responses;
+    };
+
+    /**
+     * This class transports length prefixed frames through one direction of a shm_region_t.
+     * Exactly one thread may write and exactly one thread may read at a time. If one side has
+     * to wait, it spins shortly and then sleeps on a futex (on Linux), so idle connections don't burn CPU.
+     */
+    class SharedMemoryRing
+    {
+        public:
+            SharedMemoryRing();
+
+            void Attach(shm_region_t* region, shm_ringheader_t* header, char* data);
+
+            /**
+             * Writes a whole frame (length + payload) into the ring. Blocks as long as the ring is full.
+             * @return false if the region has been closed meanwhile.
+             */
+            bool WriteFrame(const std::string& frame);
+
+            /**
+             * Reads the next whole frame out of the ring. Blocks as long as the ring is empty.
+             * @return false if the region has been closed meanwhile.
+             */
+            bool ReadFrame(std::string& frame);
+
+            /**
+             * Wakes up all threads waiting on this ring, e.g. after the region has been closed.
+             */
+            void WakeAll();
+
+            /**
+             * @return the size of the memory mapped region needed for the given capacity per direction.
+             */
+            static size_t GetRegionSize(uint32_t capacity);
+
+            /**
+             * @return the smallest power of two which is >= capacity.
+             */
+            static uint32_t NormalizeCapacity(size_t capacity);
+
+        private:
+            bool Write(const char* data, uint32_t length);
+            bool Read(char* data, uint32_t length);
+
+            shm_region_t* region;
+            shm_ringheader_t* header;
+            char* data;
+            uint32_t mask;
+    };
+
+} /* namespace jsonrpc */
+#endif /* SHAREDMEMORYRING_H_ */
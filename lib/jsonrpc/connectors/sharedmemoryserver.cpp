@@ -0,0 +1,121 @@
+/**
+ * @file sharedmemoryserver.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ServerConnector for co-located processes, exchanging frames through shared memory.
+ */
+
+#include "sharedmemoryserver.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace jsonrpc
+{
+    SharedMemoryServer::SharedMemoryServer(const std::string& name,
+            size_t capacity)
+            : ServerConnector(), name(name), region(NULL), listening(false)
+    {
+        this->capacity = SharedMemoryRing::NormalizeCapacity(capacity);
+    }
+
+    SharedMemoryServer::~SharedMemoryServer()
+    {
+        this->StopListening();
+    }
+
+    bool SharedMemoryServer::StartListening()
+    {
+        if (this->listening)
+        {
+            return true;
+        }
+
+        size_t size = SharedMemoryRing::GetRegionSize(this->capacity);
+
+        //a region left over by a crashed server must not be reused.
+        shm_unlink(this->name.c_str());
+        int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+        {
+            return false;
+        }
+        if (ftruncate(fd, size) != 0)
+        {
+            close(fd);
+            shm_unlink(this->name.c_str());
+            return false;
+        }
+        void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mem == MAP_FAILED)
+        {
+            shm_unlink(this->name.c_str());
+            return false;
+        }
+
+        this->region = (shm_region_t*) mem;
+        memset(this->region, 0, sizeof(shm_region_t));
+        this->region->capacity = this->capacity;
+
+        char* data = (char*) mem + sizeof(shm_region_t);
+        this->requests.Attach(this->region, &this->region->requests, data);
+        this->responses.Attach(this->region, &this->region->responses,
+                data + this->capacity);
+
+        //clients check the magic, so it has to be the last thing written.
+        __sync_synchronize();
+        this->region->magic = SHM_MAGIC;
+
+        if (pthread_create(&this->listener, NULL, &SharedMemoryServer::Listen,
+                this) != 0)
+        {
+            munmap(this->region, size);
+            shm_unlink(this->name.c_str());
+            this->region = NULL;
+            return false;
+        }
+        this->listening = true;
+        return true;
+    }
+
+    bool SharedMemoryServer::StopListening()
+    {
+        if (!this->listening)
+        {
+            return true;
+        }
+
+        this->region->closed = 1;
+        this->requests.WakeAll();
+        this->responses.WakeAll();
+        pthread_join(this->listener, NULL);
+
+        munmap(this->region, SharedMemoryRing::GetRegionSize(this->capacity));
+        shm_unlink(this->name.c_str());
+        this->region = NULL;
+        this->listening = false;
+        return true;
+    }
+
+    bool SharedMemoryServer::SendResponse(const std::string& response,
+            void* addInfo)
+    {
+        return this->responses.WriteFrame(response);
+    }
+
+    void* SharedMemoryServer::Listen(void* data)
+    {
+        SharedMemoryServer* _this = (SharedMemoryServer*) data;
+        string request;
+        while (_this->requests.ReadFrame(request))
+        {
+            _this->OnRequest(request, _this);
+        }
+        return NULL;
+    }
+
+} /* namespace jsonrpc */
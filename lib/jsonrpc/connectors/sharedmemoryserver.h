@@ -0,0 +1,52 @@
+/**
+ * @file sharedmemoryserver.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ServerConnector for co-located processes, exchanging frames through shared memory.
+ */
+
+#ifndef SHAREDMEMORYSERVER_H_
+#define SHAREDMEMORYSERVER_H_
+
+#include <pthread.h>
+#include "../serverconnector.h"
+#include "sharedmemoryring.h"
+
+namespace jsonrpc
+{
+    /**
+     * This class creates a POSIX shared memory region (shm_open) with two lock-free rings, one for
+     * requests and one for responses. Requests are processed by a single listener thread in the order they arrive.
+     * Because the rings are single producer / single consumer, only one SharedMemoryClient may be attached to a
+     * region at a time. Use one region per client process.
+     */
+    class SharedMemoryServer: public ServerConnector
+    {
+        public:
+            /**
+             * @param name - name of the shared memory object, e.g. "/myservice". It is created on StartListening and removed on StopListening.
+             * @param capacity - size in bytes of each ring, will be rounded up to a power of two. Frames may be larger than the capacity.
+             */
+            SharedMemoryServer(const std::string& name, size_t capacity = SHM_DEFAULT_CAPACITY);
+            virtual ~SharedMemoryServer();
+
+            virtual bool StartListening();
+            virtual bool StopListening();
+
+            bool virtual SendResponse(const std::string& response,
+                    void* addInfo = NULL);
+
+        private:
+            static void* Listen(void* data);
+
+            std::string name;
+            uint32_t capacity;
+            shm_region_t* region;
+            SharedMemoryRing requests;
+            SharedMemoryRing responses;
+            pthread_t listener;
+            bool listening;
+    };
+
+} /* namespace jsonrpc */
+#endif /* SHAREDMEMORYSERVER_H_ */
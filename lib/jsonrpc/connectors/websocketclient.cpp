@@ -0,0 +1,377 @@
+/**
+ * @file websocketclient.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ClientConnector keeping one websocket connection to a WebSocketServer.
+ */
+
+#include "websocketclient.h"
+#include "websocketframe.h"
+#include "../requesthandler.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace std;
+
+namespace jsonrpc
+{
+    static bool sendAll(int sock, const char* data, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t n = send(sock, data, length, MSG_NOSIGNAL);
+            if (n <= 0)
+            {
+                return false;
+            }
+            data += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    static bool receiveAll(int sock, char* data, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t n = recv(sock, data, length, 0);
+            if (n <= 0)
+            {
+                return false;
+            }
+            data += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    static string base64Encode(const unsigned char* src, size_t length)
+    {
+        static const char* b64 =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        string result;
+        for (size_t i = 0; i < length; i += 3)
+        {
+            int a = src[i];
+            int b = i + 1 < length ? src[i + 1] : 0;
+            int c = i + 2 < length ? src[i + 2] : 0;
+            result += b64[a >> 2];
+            result += b64[((a & 3) << 4) | (b >> 4)];
+            result += i + 1 < length ? b64[((b & 15) << 2) | (c >> 6)] : '=';
+            result += i + 2 < length ? b64[c & 63] : '=';
+        }
+        return result;
+    }
+
+    WebSocketClient::WebSocketClient(const std::string& url) throw (Exception)
+            : sock(-1), receiving(false), closed(false), hasResponse(false)
+    {
+        pthread_mutex_init(&this->callLock, NULL);
+        pthread_mutex_init(&this->writeLock, NULL);
+        pthread_mutex_init(&this->stateLock, NULL);
+        pthread_cond_init(&this->responseReady, NULL);
+        srand(time(NULL) ^ (long) this);
+
+        if (!this->Connect(url))
+        {
+            if (this->sock >= 0)
+            {
+                close(this->sock);
+            }
+            throw Exception(ERROR_CLIENT_CONNECT, "websocket handshake with " + url + " failed");
+        }
+        this->receiving = pthread_create(&this->receiver, NULL,
+                &WebSocketClient::Receive, this) == 0;
+    }
+
+    WebSocketClient::~WebSocketClient()
+    {
+        this->WriteFrame(WEBSOCKET_OPCODE_CLOSE, NULL, 0);
+        shutdown(this->sock, SHUT_RDWR);
+        if (this->receiving)
+        {
+            pthread_join(this->receiver, NULL);
+        }
+        close(this->sock);
+
+        pthread_cond_destroy(&this->responseReady);
+        pthread_mutex_destroy(&this->stateLock);
+        pthread_mutex_destroy(&this->writeLock);
+        pthread_mutex_destroy(&this->callLock);
+    }
+
+    std::string WebSocketClient::SendMessage(const std::string& message) throw (Exception)
+    {
+        string result;
+        bool ok;
+
+        pthread_mutex_lock(&this->callLock);
+        pthread_mutex_lock(&this->stateLock);
+        this->hasResponse = false;
+        pthread_mutex_unlock(&this->stateLock);
+
+        ok = this->WriteFrame(WEBSOCKET_OPCODE_TEXT, message.data(),
+                message.length());
+
+        pthread_mutex_lock(&this->stateLock);
+        while (ok && !this->hasResponse && !this->closed)
+        {
+            pthread_cond_wait(&this->responseReady, &this->stateLock);
+        }
+        ok = ok && this->hasResponse;
+        result.swap(this->response);
+        pthread_mutex_unlock(&this->stateLock);
+        pthread_mutex_unlock(&this->callLock);
+
+        if (!ok)
+        {
+            throw Exception(ERROR_CLIENT_CONNECT, "websocket connection has been closed");
+        }
+        return result;
+    }
+
+    void WebSocketClient::AddNotificationHandler(const std::string& name,
+            pNotification_t handler)
+    {
+        pthread_mutex_lock(&this->stateLock);
+        this->notifications[name] = handler;
+        pthread_mutex_unlock(&this->stateLock);
+    }
+
+    void* WebSocketClient::Receive(void* data)
+    {
+        WebSocketClient* _this = (WebSocketClient*) data;
+        string message;
+        int opcode;
+
+        while (_this->ReadMessage(opcode, message))
+        {
+            if (opcode == WEBSOCKET_OPCODE_PING)
+            {
+                _this->WriteFrame(WEBSOCKET_OPCODE_PONG, message.data(),
+                        message.length());
+            }
+            else if (opcode == WEBSOCKET_OPCODE_CLOSE)
+            {
+                break;
+            }
+            else if (opcode != WEBSOCKET_OPCODE_PONG)
+            {
+                _this->Dispatch(message);
+            }
+        }
+
+        pthread_mutex_lock(&_this->stateLock);
+        _this->closed = true;
+        pthread_cond_broadcast(&_this->responseReady);
+        pthread_mutex_unlock(&_this->stateLock);
+        return NULL;
+    }
+
+    bool WebSocketClient::Connect(const std::string& url)
+    {
+        string host, port = "80", path = "/";
+        string rest = url;
+        if (rest.compare(0, 5, "ws://") == 0)
+        {
+            rest = rest.substr(5);
+        }
+        size_t slash = rest.find('/');
+        if (slash != string::npos)
+        {
+            path = rest.substr(slash);
+            rest = rest.substr(0, slash);
+        }
+        host = rest;
+        size_t colon = rest.rfind(':');
+        if (colon != string::npos)
+        {
+            host = rest.substr(0, colon);
+            port = rest.substr(colon + 1);
+        }
+
+        struct addrinfo hints, *addresses;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+        {
+            return false;
+        }
+        for (struct addrinfo* a = addresses; a != NULL && this->sock < 0; a = a->ai_next)
+        {
+            this->sock = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (this->sock >= 0 && connect(this->sock, a->ai_addr, a->ai_addrlen) != 0)
+            {
+                close(this->sock);
+                this->sock = -1;
+            }
+        }
+        freeaddrinfo(addresses);
+        if (this->sock < 0)
+        {
+            return false;
+        }
+
+        //Requests are small and latency bound, don't let them wait for outstanding acks.
+        int flag = 1;
+        setsockopt(this->sock, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+        unsigned char nonce[16];
+        for (int i = 0; i < 16; i++)
+        {
+            nonce[i] = (unsigned char) rand();
+        }
+
+        stringstream request;
+        request << "GET " << path << " HTTP/1.1\r\n"
+                << "Host: " << host << ":" << port << "\r\n"
+                << "Upgrade: websocket\r\n"
+                << "Connection: Upgrade\r\n"
+                << "Sec-WebSocket-Key: " << base64Encode(nonce, 16) << "\r\n"
+                << "Sec-WebSocket-Version: 13\r\n"
+                << "\r\n";
+        string str = request.str();
+        if (!sendAll(this->sock, str.data(), str.length()))
+        {
+            return false;
+        }
+
+        //Read the response header byte by byte, so no frame following it is swallowed.
+        string header;
+        char c;
+        while (header.length() < 4
+                || header.compare(header.length() - 4, 4, "\r\n\r\n") != 0)
+        {
+            if (header.length() > 8192 || !receiveAll(this->sock, &c, 1))
+            {
+                return false;
+            }
+            header += c;
+        }
+        return header.compare(0, 12, "HTTP/1.1 101") == 0;
+    }
+
+    bool WebSocketClient::WriteFrame(int opcode, const char* data,
+            size_t length)
+    {
+        unsigned char mask[4];
+        unsigned char header[WEBSOCKET_MAX_HEADER];
+        for (int i = 0; i < 4; i++)
+        {
+            mask[i] = (unsigned char) rand();
+        }
+        size_t headerLength = BuildWebSocketHeader(header, opcode, length, mask);
+
+        string frame;
+        frame.reserve(headerLength + length);
+        frame.append((const char*) header, headerLength);
+        frame.append(data, length);
+        MaskWebSocketPayload(&frame[headerLength], length, mask);
+
+        pthread_mutex_lock(&this->writeLock);
+        bool result = sendAll(this->sock, frame.data(), frame.length());
+        pthread_mutex_unlock(&this->writeLock);
+        return result;
+    }
+
+    bool WebSocketClient::ReadMessage(int& opcode, std::string& message)
+    {
+        unsigned char header[WEBSOCKET_MAX_HEADER];
+        unsigned char mask[4];
+        uint64_t length;
+        bool fin = false;
+
+        message.clear();
+        while (!fin)
+        {
+            if (!receiveAll(this->sock, (char*) header, 2)
+                    || !receiveAll(this->sock, (char*) header + 2,
+                            GetWebSocketHeaderRemainder(header)))
+            {
+                return false;
+            }
+            bool masked = ParseWebSocketHeader(header, length, mask);
+            int frameOpcode = header[0] & 0x0F;
+            fin = (header[0] & 0x80) != 0;
+
+            string control;
+            string& payload = (frameOpcode & 0x08) ? control : message;
+            size_t offset = payload.length();
+            payload.resize(offset + length);
+            if (length > 0 && !receiveAll(this->sock, &payload[offset], length))
+            {
+                return false;
+            }
+            if (masked)
+            {
+                MaskWebSocketPayload(&payload[offset], length, mask);
+            }
+
+            if (frameOpcode & 0x08)
+            {
+                //Control frames may be interleaved with fragments, hand them out right away.
+                opcode = frameOpcode;
+                message.swap(control);
+                return true;
+            }
+            if (frameOpcode != WEBSOCKET_OPCODE_CONTINUATION)
+            {
+                opcode = frameOpcode;
+            }
+        }
+        return true;
+    }
+
+    void WebSocketClient::Dispatch(const std::string& message)
+    {
+        //Only messages naming a method can be requests of the server, this check saves parsing every response.
+        if (message.find("\"" KEY_REQUEST_METHODNAME "\"") != string::npos)
+        {
+            Json::Reader reader;
+            Json::Value request;
+            if (reader.parse(message, request, false) && request.isObject()
+                    && request.isMember(KEY_REQUEST_METHODNAME)
+                    && !request.isMember(KEY_RESPONSE_RESULT)
+                    && !request.isMember(KEY_RESPONSE_ERROR))
+            {
+                pNotification_t handler = NULL;
+                pthread_mutex_lock(&this->stateLock);
+                map<string, pNotification_t>::iterator it =
+                        this->notifications.find(
+                                request[KEY_REQUEST_METHODNAME].asString());
+                if (it != this->notifications.end())
+                {
+                    handler = it->second;
+                }
+                pthread_mutex_unlock(&this->stateLock);
+
+                if (handler != NULL)
+                {
+                    (*handler)(request[KEY_REQUEST_PARAMETERS]);
+                }
+                return;
+            }
+        }
+
+        pthread_mutex_lock(&this->stateLock);
+        this->response = message;
+        this->hasResponse = true;
+        pthread_cond_signal(&this->responseReady);
+        pthread_mutex_unlock(&this->stateLock);
+    }
+
+} /* namespace jsonrpc */
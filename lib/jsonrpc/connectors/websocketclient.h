@@ -0,0 +1,70 @@
+/**
+ * @file websocketclient.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief ClientConnector keeping one websocket connection to a WebSocketServer.
+ */
+
+#ifndef WEBSOCKETCLIENT_H_
+#define WEBSOCKETCLIENT_H_
+
+#include <map>
+#include <pthread.h>
+#include "../clientconnector.h"
+#include "../exception.h"
+#include "../procedure.h"
+
+namespace jsonrpc
+{
+    /**
+     * This connector performs the websocket handshake once and sends all further requests as messages over the same
+     * connection. A background thread receives the messages of the server: responses are handed to the waiting
+     * SendMessage call, JSON-RPC notifications pushed by the server are dispatched to the registered handlers.
+     * Calls from different threads are serialized, since JSON-RPC responses are matched in order.
+     */
+    class WebSocketClient : public ClientConnector
+    {
+        public:
+            /**
+             * @param url - e.g. ws://localhost:8080/
+             * @throws Exception with ERROR_CLIENT_CONNECT if the connection or the handshake failed.
+             */
+            WebSocketClient(const std::string& url) throw (Exception);
+            virtual ~WebSocketClient();
+
+            virtual std::string SendMessage(const std::string& message) throw (Exception);
+
+            /**
+             * Registers a handler for notifications with the given name pushed by the server.
+             * Handlers are called from the receiving thread, so they should return quickly and must not call SendMessage.
+             */
+            void AddNotificationHandler(const std::string& name, pNotification_t handler);
+
+        private:
+            static void* Receive(void* data);
+
+            bool Connect(const std::string& url);
+            bool WriteFrame(int opcode, const char* data, size_t length);
+            /**
+             * Reads the next complete message (or control frame) of the server.
+             */
+            bool ReadMessage(int& opcode, std::string& message);
+            void Dispatch(const std::string& message);
+
+            int sock;
+            pthread_t receiver;
+            bool receiving;
+
+            pthread_mutex_t callLock;
+            pthread_mutex_t writeLock;
+            pthread_mutex_t stateLock;
+            pthread_cond_t responseReady;
+
+            bool closed;
+            bool hasResponse;
+            std::string response;
+            std::map<std::string, pNotification_t> notifications;
+    };
+
+} /* namespace jsonrpc */
+#endif /* WEBSOCKETCLIENT_H_ */
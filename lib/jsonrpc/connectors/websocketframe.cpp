@@ -0,0 +1,100 @@
+/**
+ * @file websocketframe.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Helpers for RFC 6455 websocket framing, shared by WebSocketServer and WebSocketClient.
+ */
+
+#include "websocketframe.h"
+#include <cstring>
+
+namespace jsonrpc
+{
+    size_t BuildWebSocketHeader(unsigned char* header, int opcode,
+            uint64_t length, const unsigned char* mask)
+    {
+        size_t pos = 2;
+        header[0] = 0x80 | (opcode & 0x0F);
+        if (length < 126)
+        {
+            header[1] = (unsigned char) length;
+        }
+        else if (length <= 0xFFFF)
+        {
+            header[1] = 126;
+            header[2] = (unsigned char) (length >> 8);
+            header[3] = (unsigned char) length;
+            pos = 4;
+        }
+        else
+        {
+            header[1] = 127;
+            for (int i = 0; i < 8; i++)
+            {
+                header[2 + i] = (unsigned char) (length >> (56 - 8 * i));
+            }
+            pos = 10;
+        }
+
+        if (mask != NULL)
+        {
+            header[1] |= 0x80;
+            memcpy(header + pos, mask, 4);
+            pos += 4;
+        }
+        return pos;
+    }
+
+    size_t GetWebSocketHeaderRemainder(const unsigned char* header)
+    {
+        size_t result = (header[1] & 0x80) ? 4 : 0;
+        switch (header[1] & 0x7F)
+        {
+            case 126:
+                result += 2;
+                break;
+            case 127:
+                result += 8;
+                break;
+        }
+        return result;
+    }
+
+    bool ParseWebSocketHeader(const unsigned char* header, uint64_t& length,
+            unsigned char* mask)
+    {
+        size_t pos = 2;
+        length = header[1] & 0x7F;
+        if (length == 126)
+        {
+            length = ((uint64_t) header[2] << 8) | header[3];
+            pos = 4;
+        }
+        else if (length == 127)
+        {
+            length = 0;
+            for (int i = 0; i < 8; i++)
+            {
+                length = (length << 8) | header[2 + i];
+            }
+            pos = 10;
+        }
+
+        if (header[1] & 0x80)
+        {
+            memcpy(mask, header + pos, 4);
+            return true;
+        }
+        return false;
+    }
+
+    void MaskWebSocketPayload(char* data, size_t length,
+            const unsigned char* mask, size_t offset)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            data[i] ^= mask[(offset + i) & 3];
+        }
+    }
+
+} /* namespace jsonrpc */
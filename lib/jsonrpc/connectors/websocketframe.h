@@ -0,0 +1,71 @@
+/**
+ * @file websocketframe.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Helpers for RFC 6455 websocket framing, shared by WebSocketServer and WebSocketClient.
+ */
+
+#ifndef WEBSOCKETFRAME_H_
+#define WEBSOCKETFRAME_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+#define WEBSOCKET_OPCODE_CONTINUATION 0x0
+#define WEBSOCKET_OPCODE_TEXT 0x1
+#define WEBSOCKET_OPCODE_BINARY 0x2
+#define WEBSOCKET_OPCODE_CLOSE 0x8
+#define WEBSOCKET_OPCODE_PING 0x9
+#define WEBSOCKET_OPCODE_PONG 0xA
+
+/**
+ * Maximum size of a frame header (2 bytes + 8 bytes extended length + 4 bytes mask).
+ */
+#define WEBSOCKET_MAX_HEADER 14
+
+/**
+ * Control frames (close, ping, pong) must not carry a bigger payload.
+ */
+#define WEBSOCKET_MAX_CONTROL_PAYLOAD 125
+
+/**
+ * Status codes of close frames.
+ */
+#define WEBSOCKET_CLOSE_PROTOCOL_ERROR 1002
+#define WEBSOCKET_CLOSE_MESSAGE_TOO_BIG 1009
+
+namespace jsonrpc
+{
+    /**
+     * Builds the header of a single, unfragmented frame.
+     * @param header - must have room for WEBSOCKET_MAX_HEADER bytes.
+     * @param opcode - one of the WEBSOCKET_OPCODE_* constants.
+     * @param length - length of the payload which follows the header.
+     * @param mask - 4 byte masking key (required for frames sent by clients), NULL for unmasked frames.
+     * @return the number of header bytes written.
+     */
+    size_t BuildWebSocketHeader(unsigned char* header, int opcode, uint64_t length, const unsigned char* mask);
+
+    /**
+     * @param header - the first two bytes of a frame.
+     * @return number of header bytes still to be read after the first two (extended length and masking key).
+     */
+    size_t GetWebSocketHeaderRemainder(const unsigned char* header);
+
+    /**
+     * Decodes a complete frame header.
+     * @param header - the complete header.
+     * @param length - will hold the payload length.
+     * @param mask - will hold the masking key, if the frame is masked.
+     * @return true if the frame is masked.
+     */
+    bool ParseWebSocketHeader(const unsigned char* header, uint64_t& length, unsigned char* mask);
+
+    /**
+     * Applies (or removes) the masking key to a payload in place.
+     * @param offset - position of data within the whole payload.
+     */
+    void MaskWebSocketPayload(char* data, size_t length, const unsigned char* mask, size_t offset = 0);
+
+} /* namespace jsonrpc */
+#endif /* WEBSOCKETFRAME_H_ */
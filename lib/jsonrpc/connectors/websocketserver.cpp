@@ -0,0 +1,304 @@
+/**
+ * @file websocketserver.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief HttpServer which additionally accepts long-lived websocket sessions.
+ */
+
+#include "websocketserver.h"
+#include "websocketframe.h"
+#include "../requesthandler.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace jsonrpc
+{
+    /**
+     * mg_read might return less than requested, this function loops until everything has been read.
+     */
+    static bool readFully(struct mg_connection* conn, char* buffer, size_t length)
+    {
+        while (length > 0)
+        {
+            int n = mg_read(conn, buffer, length);
+            if (n <= 0)
+            {
+                return false;
+            }
+            buffer += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    WebSocketServer::WebSocketServer(int port)
+            : HttpServer(port, "")
+    {
+        pthread_mutex_init(&this->sessionsLock, NULL);
+    }
+
+    WebSocketServer::WebSocketServer(int port,
+            const std::string& getResourcePath)
+            : HttpServer(port, getResourcePath)
+    {
+        pthread_mutex_init(&this->sessionsLock, NULL);
+    }
+
+    WebSocketServer::~WebSocketServer()
+    {
+        pthread_mutex_destroy(&this->sessionsLock);
+    }
+
+    bool WebSocketServer::SendResponse(const std::string& response,
+            void* addInfo)
+    {
+        websocket_session_t* session = this->FindSession(
+                (struct mg_connection*) addInfo);
+        if (session == NULL)
+        {
+            return HttpServer::SendResponse(response, addInfo);
+        }
+        //A session is only removed by its own thread, which is the one calling us here.
+        return this->WriteFrame(session, WEBSOCKET_OPCODE_TEXT,
+                response.data(), response.length());
+    }
+
+    ResponseStream* WebSocketServer::CreateResponseStream(void* addInfo)
+    {
+        if (this->FindSession((struct mg_connection*) addInfo) != NULL)
+        {
+            //results are collected and sent as one message
+            return NULL;
+        }
+        return HttpServer::CreateResponseStream(addInfo);
+    }
+
+    void* WebSocketServer::OnWebSocketEvent(enum mg_event event,
+            struct mg_connection* conn)
+    {
+        websocket_session_t* session;
+        map<struct mg_connection*, websocket_session_t*>::iterator it;
+
+        switch (event)
+        {
+            case MG_WEBSOCKET_CONNECT:
+                //Proceed with the handshake
+                return NULL;
+
+            case MG_WEBSOCKET_READY:
+                session = new websocket_session_t;
+                session->conn = conn;
+                pthread_mutex_init(&session->writeLock, NULL);
+                session->closed = false;
+                session->references = 1;
+                pthread_mutex_lock(&this->sessionsLock);
+                this->sessions[conn] = session;
+                pthread_mutex_unlock(&this->sessionsLock);
+                return NULL;
+
+            case MG_WEBSOCKET_MESSAGE:
+                pthread_mutex_lock(&this->sessionsLock);
+                it = this->sessions.find(conn);
+                session = it != this->sessions.end() ? it->second : NULL;
+                pthread_mutex_unlock(&this->sessionsLock);
+                if (session == NULL || !this->ReadFrame(session))
+                {
+                    //Tell mongoose to close the session
+                    return (void*) "";
+                }
+                return NULL;
+
+            case MG_WEBSOCKET_CLOSE:
+                pthread_mutex_lock(&this->sessionsLock);
+                it = this->sessions.find(conn);
+                session = it != this->sessions.end() ? it->second : NULL;
+                if (session != NULL)
+                {
+                    this->sessions.erase(it);
+                }
+                pthread_mutex_unlock(&this->sessionsLock);
+                if (session != NULL)
+                {
+                    //waits for a running write, the connection is invalid once we return
+                    pthread_mutex_lock(&session->writeLock);
+                    session->closed = true;
+                    pthread_mutex_unlock(&session->writeLock);
+                    this->Release(session);
+                }
+                return NULL;
+
+            default:
+                return NULL;
+        }
+    }
+
+    int WebSocketServer::SendNotification(const std::string& name,
+            const Json::Value& parameters)
+    {
+        Json::Value request;
+        Json::FastWriter writer;
+        int count = 0;
+
+        request[KEY_REQUEST_VERSION] = JSON_RPC_VERSION;
+        request[KEY_REQUEST_METHODNAME] = name;
+        request[KEY_REQUEST_PARAMETERS] = parameters;
+        string message = writer.write(request);
+
+        //The sessions are referenced, so slow clients don't block the registration of others while we write.
+        vector<websocket_session_t*> receivers;
+        pthread_mutex_lock(&this->sessionsLock);
+        receivers.reserve(this->sessions.size());
+        for (map<struct mg_connection*, websocket_session_t*>::iterator it =
+                this->sessions.begin(); it != this->sessions.end(); it++)
+        {
+            it->second->references++;
+            receivers.push_back(it->second);
+        }
+        pthread_mutex_unlock(&this->sessionsLock);
+
+        for (size_t i = 0; i < receivers.size(); i++)
+        {
+            if (this->WriteFrame(receivers[i], WEBSOCKET_OPCODE_TEXT,
+                    message.data(), message.length()))
+            {
+                count++;
+            }
+            this->Release(receivers[i]);
+        }
+        return count;
+    }
+
+    int WebSocketServer::GetSessionCount()
+    {
+        pthread_mutex_lock(&this->sessionsLock);
+        int result = this->sessions.size();
+        pthread_mutex_unlock(&this->sessionsLock);
+        return result;
+    }
+
+    websocket_session_t* WebSocketServer::FindSession(
+            struct mg_connection* conn)
+    {
+        websocket_session_t* session = NULL;
+        pthread_mutex_lock(&this->sessionsLock);
+        map<struct mg_connection*, websocket_session_t*>::iterator it =
+                this->sessions.find(conn);
+        if (it != this->sessions.end())
+        {
+            session = it->second;
+        }
+        pthread_mutex_unlock(&this->sessionsLock);
+        return session;
+    }
+
+    void WebSocketServer::Release(websocket_session_t* session)
+    {
+        pthread_mutex_lock(&this->sessionsLock);
+        bool last = --session->references == 0;
+        pthread_mutex_unlock(&this->sessionsLock);
+        if (last)
+        {
+            pthread_mutex_destroy(&session->writeLock);
+            delete session;
+        }
+    }
+
+    bool WebSocketServer::WriteFrame(websocket_session_t* session, int opcode,
+            const char* data, size_t length)
+    {
+        unsigned char header[WEBSOCKET_MAX_HEADER];
+        size_t headerLength = BuildWebSocketHeader(header, opcode, length,
+                NULL);
+
+        pthread_mutex_lock(&session->writeLock);
+        bool result = !session->closed
+                && mg_write(session->conn, header, headerLength)
+                == (int) headerLength
+                && (length == 0
+                        || mg_write(session->conn, data, length)
+                                == (int) length);
+        pthread_mutex_unlock(&session->writeLock);
+        return result;
+    }
+
+    void WebSocketServer::WriteClose(websocket_session_t* session, int code)
+    {
+        char status[2];
+        status[0] = (char) (code >> 8);
+        status[1] = (char) (code & 0xFF);
+        this->WriteFrame(session, WEBSOCKET_OPCODE_CLOSE, status, 2);
+    }
+
+    bool WebSocketServer::ReadFrame(websocket_session_t* session)
+    {
+        unsigned char header[WEBSOCKET_MAX_HEADER];
+        unsigned char mask[4];
+        uint64_t length;
+
+        if (!readFully(session->conn, (char*) header, 2)
+                || !readFully(session->conn, (char*) header + 2,
+                        GetWebSocketHeaderRemainder(header)))
+        {
+            return false;
+        }
+        bool masked = ParseWebSocketHeader(header, length, mask);
+        bool fin = (header[0] & 0x80) != 0;
+        int opcode = header[0] & 0x0F;
+
+        string control;
+        string& payload =
+                (opcode & 0x08) ? control : session->message;
+        size_t offset = payload.length();
+        if ((opcode & 0x08) && length > WEBSOCKET_MAX_CONTROL_PAYLOAD)
+        {
+            this->WriteClose(session, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+            return false;
+        }
+        //the length is chosen by the client, fragments of a message are limited in total
+        size_t limit = std::min(this->GetMaxRequestSize(), payload.max_size());
+        if (length > limit || offset > limit - length)
+        {
+            this->WriteClose(session, WEBSOCKET_CLOSE_MESSAGE_TOO_BIG);
+            return false;
+        }
+        payload.resize(offset + length);
+        if (length > 0)
+        {
+            if (!readFully(session->conn, &payload[offset], length))
+            {
+                return false;
+            }
+            if (masked)
+            {
+                MaskWebSocketPayload(&payload[offset], length, mask);
+            }
+        }
+
+        switch (opcode)
+        {
+            case WEBSOCKET_OPCODE_CLOSE:
+                this->WriteFrame(session, WEBSOCKET_OPCODE_CLOSE,
+                        control.data(), control.length() < 2 ? control.length() : 2);
+                return false;
+
+            case WEBSOCKET_OPCODE_PING:
+                return this->WriteFrame(session, WEBSOCKET_OPCODE_PONG,
+                        control.data(), control.length());
+
+            case WEBSOCKET_OPCODE_PONG:
+                return true;
+
+            default:
+                if (fin)
+                {
+                    string request;
+                    request.swap(session->message);
+                    this->OnRequest(request, session->conn);
+                }
+                return true;
+        }
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,113 @@
+/**
+ * @file websocketserver.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief HttpServer which additionally accepts long-lived websocket sessions.
+ */
+
+#ifndef WEBSOCKETSERVER_H_
+#define WEBSOCKETSERVER_H_
+
+#include <map>
+#include <pthread.h>
+#include "httpserver.h"
+
+namespace jsonrpc
+{
+    /**
+     * State of one upgraded connection.
+     */
+    typedef struct
+    {
+            struct mg_connection* conn;
+            /**
+             * Responses and server-initiated notifications may be sent from different threads.
+             */
+            pthread_mutex_t writeLock;
+            /**
+             * Collects the payload of fragmented messages.
+             */
+            std::string message;
+            /**
+             * Set under writeLock when the connection is closed, nothing is written to it afterwards.
+             */
+            bool closed;
+            /**
+             * Number of threads using the session, protected by sessionsLock. The connection holds one
+             * reference until it is closed, SendNotification one while it writes.
+             */
+            int references;
+    } websocket_session_t;
+
+    /**
+     * This connector upgrades connections of the embedded HTTP server to websockets (RFC 6455, version 13).
+     * Each websocket message is handled as one JSON-RPC request (or batch) and answered with one message on the same
+     * connection. POST requests are still answered as in HttpServer, so both kinds of clients can use the same port.
+     *
+     * Messages bigger than the maximum request size (see HttpServer::SetMaxRequestSize) close the session with status 1009.
+     *
+     * Note that mongoose serves each websocket session with one of its worker threads for the whole lifetime of the session.
+     */
+    class WebSocketServer: public HttpServer
+    {
+        public:
+            WebSocketServer(int port);
+            WebSocketServer(int port, const std::string& getResourcePath);
+            virtual ~WebSocketServer();
+
+            bool virtual SendResponse(const std::string& response,
+                    void* addInfo = NULL);
+
+            /**
+             * Results of streaming methods called over a websocket are collected and sent as a single message,
+             * POST requests are streamed as in HttpServer.
+             */
+            virtual ResponseStream* CreateResponseStream(void* addInfo);
+
+            virtual void* OnWebSocketEvent(enum mg_event event, struct mg_connection* conn);
+
+            /**
+             * Pushes a JSON-RPC notification to every connected websocket client.
+             * @return the number of clients the notification has been sent to.
+             */
+            int SendNotification(const std::string& name, const Json::Value& parameters);
+
+            /**
+             * @return the number of currently connected websocket clients.
+             */
+            int GetSessionCount();
+
+        private:
+            /**
+             * @return the session of an upgraded connection, or NULL for plain HTTP connections.
+             */
+            websocket_session_t* FindSession(struct mg_connection* conn);
+
+            /**
+             * Gives a reference of the session back, it is deleted with the last one.
+             */
+            void Release(websocket_session_t* session);
+
+            /**
+             * @return false if the connection has been closed or the frame could not be written.
+             */
+            bool WriteFrame(websocket_session_t* session, int opcode, const char* data, size_t length);
+
+            /**
+             * Sends a close frame with this status code.
+             */
+            void WriteClose(websocket_session_t* session, int code);
+
+            /**
+             * Reads one frame of the session and reacts on it. Messages bigger than the maximum request size
+             * (see HttpServer::SetMaxRequestSize) are refused with status 1009 before their payload is read.
+             * @return false if the session should be closed.
+             */
+            bool ReadFrame(websocket_session_t* session);
+
+            std::map<struct mg_connection*, websocket_session_t*> sessions;
+            pthread_mutex_t sessionsLock;
+    };
+
+} /* namespace jsonrpc */
+#endif /* WEBSOCKETSERVER_H_ */
@@ -0,0 +1,158 @@
+/**
+ * @file filewatcher.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Calls back from a background thread whenever a file has been rewritten (inotify).
+ */
+
+#include "filewatcher.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+using namespace std;
+
+namespace jsonrpc
+{
+    FileWatcher::FileWatcher(const std::string& file, pFileChanged_t callback,
+            void* data)
+            : callback(callback), data(data), inotify(-1), running(false)
+    {
+        size_t separator = file.rfind('/');
+        if (separator == string::npos)
+        {
+            this->directory = ".";
+            this->filename = file;
+        }
+        else
+        {
+            this->directory = separator == 0 ? "/" : file.substr(0, separator);
+            this->filename = file.substr(separator + 1);
+        }
+        this->stopPipe[0] = this->stopPipe[1] = -1;
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        this->Stop();
+    }
+
+    bool FileWatcher::Start()
+    {
+        if (this->running)
+        {
+            return true;
+        }
+#ifdef __linux__
+        this->inotify = inotify_init();
+        if (this->inotify < 0)
+        {
+            return false;
+        }
+        if (inotify_add_watch(this->inotify, this->directory.c_str(),
+                IN_CLOSE_WRITE | IN_MOVED_TO) < 0 || pipe(this->stopPipe) != 0)
+        {
+            close(this->inotify);
+            this->inotify = -1;
+            return false;
+        }
+        if (pthread_create(&this->thread, NULL, &FileWatcher::Watch, this) != 0)
+        {
+            close(this->stopPipe[0]);
+            close(this->stopPipe[1]);
+            close(this->inotify);
+            this->inotify = -1;
+            return false;
+        }
+        this->running = true;
+        return true;
+#else
+        //there is no inotify on this platform
+        return false;
+#endif
+    }
+
+    void FileWatcher::Stop()
+    {
+        if (!this->running)
+        {
+            return;
+        }
+        char stop = 0;
+        if (write(this->stopPipe[1], &stop, 1) != 1)
+        {
+            //the pipe is empty, so this can't happen. Closing it wakes up the thread as well.
+            close(this->stopPipe[1]);
+            this->stopPipe[1] = -1;
+        }
+        pthread_join(this->thread, NULL);
+        close(this->stopPipe[0]);
+        if (this->stopPipe[1] >= 0)
+        {
+            close(this->stopPipe[1]);
+        }
+        close(this->inotify);
+        this->inotify = -1;
+        this->running = false;
+    }
+
+    void* FileWatcher::Watch(void* watcher)
+    {
+#ifdef __linux__
+        FileWatcher* _this = (FileWatcher*) watcher;
+        //room for at least one event with the longest possible name
+        char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+        struct pollfd fds[2];
+        fds[0].fd = _this->inotify;
+        fds[0].events = POLLIN;
+        fds[1].fd = _this->stopPipe[0];
+        fds[1].events = POLLIN;
+
+        while (true)
+        {
+            if (poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            if (fds[1].revents != 0)
+            {
+                break;
+            }
+            ssize_t length = read(_this->inotify, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                continue;
+            }
+
+            //several events of one read are reported with a single call
+            bool changed = false;
+            for (char* p = buffer; p < buffer + length;)
+            {
+                struct inotify_event* event = (struct inotify_event*) p;
+                if (event->len > 0 && _this->filename == event->name)
+                {
+                    changed = true;
+                }
+                p += sizeof(struct inotify_event) + event->len;
+            }
+            if (changed)
+            {
+                _this->callback(_this->data);
+            }
+        }
+#endif
+        return NULL;
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,65 @@
+/**
+ * @file filewatcher.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Calls back from a background thread whenever a file has been rewritten (inotify).
+ */
+
+#ifndef FILEWATCHER_H_
+#define FILEWATCHER_H_
+
+#include <string>
+#include <pthread.h>
+
+namespace jsonrpc
+{
+    /**
+     * Type declaration signature of the callback of a FileWatcher.
+     * @param data - the pointer passed to the constructor of the FileWatcher.
+     */
+    typedef void (*pFileChanged_t)(void* data);
+
+    /**
+     * Watches the directory of a file, so files which are replaced by a rename (as most editors and deployment tools do)
+     * are noticed as well as files which are written in place. The callback is called after the file has been closed
+     * or moved into place, never while it is still being written.
+     */
+    class FileWatcher
+    {
+        public:
+            FileWatcher(const std::string& file, pFileChanged_t callback, void* data);
+
+            /**
+             * Stops watching.
+             */
+            ~FileWatcher();
+
+            /**
+             * @return false if the directory can't be watched, always on platforms without inotify.
+             */
+            bool Start();
+
+            /**
+             * Waits until a running callback has returned, it must therefore not be called by the callback itself.
+             */
+            void Stop();
+
+        private:
+            static void* Watch(void* watcher);
+
+            std::string directory;
+            std::string filename;
+            pFileChanged_t callback;
+            void* data;
+
+            int inotify;
+            /**
+             * Stop writes into this pipe to wake up the watching thread.
+             */
+            int stopPipe[2];
+            pthread_t thread;
+            bool running;
+    };
+
+} /* namespace jsonrpc */
+#endif /* FILEWATCHER_H_ */
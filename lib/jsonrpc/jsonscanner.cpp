@@ -0,0 +1,387 @@
+/**
+ * @file jsonscanner.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Reads typed values out of a JSON text without building a Json::Value.
+ */
+
+#include "jsonscanner.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+
+using namespace std;
+
+namespace jsonrpc
+{
+    JsonScanner::JsonScanner()
+            : data(NULL), length(0), position(0), failed(false)
+    {
+    }
+
+    JsonScanner::JsonScanner(const char* data, size_t length)
+            : data(data), length(length), position(0), failed(false)
+    {
+    }
+
+    void JsonScanner::Reset(const char* data, size_t length)
+    {
+        this->data = data;
+        this->length = length;
+        this->position = 0;
+        this->failed = false;
+    }
+
+    bool JsonScanner::BeginObject()
+    {
+        if (this->Peek() != '{')
+        {
+            return false;
+        }
+        this->position++;
+        return true;
+    }
+
+    bool JsonScanner::NextMember(const char*& name, size_t& length)
+    {
+        char c = this->Peek();
+        if (c == ',')
+        {
+            this->position++;
+            c = this->Peek();
+        }
+        if (c == '}')
+        {
+            this->position++;
+            return false;
+        }
+        size_t begin = this->position + 1;
+        if (c != '"' || !this->SkipString())
+        {
+            return this->Fail();
+        }
+        name = this->data + begin;
+        length = this->position - begin - 1;
+        if (this->Peek() != ':')
+        {
+            return this->Fail();
+        }
+        this->position++;
+        return true;
+    }
+
+    bool JsonScanner::BeginArray()
+    {
+        if (this->Peek() != '[')
+        {
+            return false;
+        }
+        this->position++;
+        return true;
+    }
+
+    bool JsonScanner::NextElement()
+    {
+        char c = this->Peek();
+        if (c == ',')
+        {
+            this->position++;
+            c = this->Peek();
+        }
+        if (c == ']')
+        {
+            this->position++;
+            return false;
+        }
+        return c != 0 || this->Fail();
+    }
+
+    bool JsonScanner::IsNull()
+    {
+        if (this->Peek() != 'n' || this->length - this->position < 4
+                || memcmp(this->data + this->position, "null", 4) != 0)
+        {
+            return false;
+        }
+        this->position += 4;
+        return true;
+    }
+
+    bool JsonScanner::Read(int& value)
+    {
+        char number[32];
+        size_t start = this->position;
+        if (!this->ReadNumber(number, sizeof(number))
+                || strpbrk(number, ".eE") != NULL)
+        {
+            this->position = start;
+            return false;
+        }
+        long long v = strtoll(number, NULL, 10);
+        if (v < INT_MIN || v > INT_MAX)
+        {
+            this->position = start;
+            return false;
+        }
+        value = (int) v;
+        return true;
+    }
+
+    bool JsonScanner::Read(double& value)
+    {
+        char number[64];
+        if (!this->ReadNumber(number, sizeof(number)))
+        {
+            return false;
+        }
+        value = strtod(number, NULL);
+        return true;
+    }
+
+    bool JsonScanner::Read(bool& value)
+    {
+        char c = this->Peek();
+        size_t remaining = this->length - this->position;
+        if (c == 't' && remaining >= 4
+                && memcmp(this->data + this->position, "true", 4) == 0)
+        {
+            this->position += 4;
+            value = true;
+            return true;
+        }
+        if (c == 'f' && remaining >= 5
+                && memcmp(this->data + this->position, "false", 5) == 0)
+        {
+            this->position += 5;
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool JsonScanner::Read(std::string& value)
+    {
+        if (this->Peek() != '"')
+        {
+            return false;
+        }
+        size_t begin = this->position + 1;
+        if (!this->SkipString())
+        {
+            return false;
+        }
+        const char* p = this->data + begin;
+        const char* end = this->data + this->position - 1;
+        const char* escape = (const char*) memchr(p, '\\', end - p);
+        if (escape == NULL)
+        {
+            value.assign(p, end);
+            return true;
+        }
+
+        value.assign(p, escape);
+        for (p = escape; p < end; p++)
+        {
+            if (*p != '\\')
+            {
+                value += *p;
+                continue;
+            }
+            switch (*++p)
+            {
+                case 'b':
+                    value += '\b';
+                    break;
+                case 'f':
+                    value += '\f';
+                    break;
+                case 'n':
+                    value += '\n';
+                    break;
+                case 'r':
+                    value += '\r';
+                    break;
+                case 't':
+                    value += '\t';
+                    break;
+                case 'u':
+                {
+                    if (end - p < 5)
+                    {
+                        return this->Fail();
+                    }
+                    unsigned long code = strtoul(string(p + 1, 4).c_str(), NULL, 16);
+                    p += 4;
+                    if (code >= 0xD800 && code < 0xDC00 && end - p >= 7
+                            && p[1] == '\\' && p[2] == 'u')
+                    {
+                        unsigned long low = strtoul(string(p + 3, 4).c_str(), NULL, 16);
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    if (code < 0x80)
+                    {
+                        value += (char) code;
+                    }
+                    else if (code < 0x800)
+                    {
+                        value += (char) (0xC0 | (code >> 6));
+                        value += (char) (0x80 | (code & 0x3F));
+                    }
+                    else if (code < 0x10000)
+                    {
+                        value += (char) (0xE0 | (code >> 12));
+                        value += (char) (0x80 | ((code >> 6) & 0x3F));
+                        value += (char) (0x80 | (code & 0x3F));
+                    }
+                    else
+                    {
+                        value += (char) (0xF0 | (code >> 18));
+                        value += (char) (0x80 | ((code >> 12) & 0x3F));
+                        value += (char) (0x80 | ((code >> 6) & 0x3F));
+                        value += (char) (0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    //\" \\ and \/
+                    value += *p;
+                    break;
+            }
+        }
+        return true;
+    }
+
+    bool JsonScanner::Read(Json::Value& value)
+    {
+        this->Peek();
+        size_t begin = this->position;
+        if (!this->Skip())
+        {
+            return false;
+        }
+        Json::Reader reader;
+        return reader.parse(this->data + begin, this->data + this->position,
+                value, false) || this->Fail();
+    }
+
+    bool JsonScanner::Skip()
+    {
+        char c = this->Peek();
+        if (c == '"')
+        {
+            return this->SkipString();
+        }
+        if (c == '{' || c == '[')
+        {
+            int depth = 0;
+            while (this->position < this->length)
+            {
+                c = this->data[this->position];
+                if (c == '"')
+                {
+                    if (!this->SkipString())
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                this->position++;
+                if (c == '{' || c == '[')
+                {
+                    depth++;
+                }
+                else if ((c == '}' || c == ']') && --depth == 0)
+                {
+                    return true;
+                }
+            }
+            return this->Fail();
+        }
+        //numbers and literals
+        size_t begin = this->position;
+        while (this->position < this->length
+                && strchr(",}] \t\r\n", this->data[this->position]) == NULL)
+        {
+            this->position++;
+        }
+        return this->position > begin || this->Fail();
+    }
+
+    bool JsonScanner::Failed() const
+    {
+        return this->failed;
+    }
+
+    bool JsonScanner::Matches(const char* name, size_t length,
+            const char* expected)
+    {
+        return strncmp(name, expected, length) == 0 && expected[length] == 0;
+    }
+
+    char JsonScanner::Peek()
+    {
+        if (this->failed)
+        {
+            return 0;
+        }
+        while (this->position < this->length)
+        {
+            char c = this->data[this->position];
+            if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+            {
+                return c;
+            }
+            this->position++;
+        }
+        return 0;
+    }
+
+    bool JsonScanner::Fail()
+    {
+        this->failed = true;
+        return false;
+    }
+
+    bool JsonScanner::ReadNumber(char* number, size_t size)
+    {
+        char c = this->Peek();
+        if (c != '-' && (c < '0' || c > '9'))
+        {
+            return false;
+        }
+        size_t i = 0;
+        while (this->position < this->length
+                && strchr("+-.eE0123456789", this->data[this->position]) != NULL
+                && this->data[this->position] != 0)
+        {
+            if (i + 1 == size)
+            {
+                return this->Fail();
+            }
+            number[i++] = this->data[this->position++];
+        }
+        number[i] = 0;
+        return true;
+    }
+
+    bool JsonScanner::SkipString()
+    {
+        //the scanner stands on the opening quote
+        for (size_t i = this->position + 1; i < this->length; i++)
+        {
+            if (this->data[i] == '\\')
+            {
+                i++;
+            }
+            else if (this->data[i] == '"')
+            {
+                this->position = i + 1;
+                return true;
+            }
+        }
+        return this->Fail();
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,102 @@
+/**
+ * @file jsonscanner.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Reads typed values out of a JSON text without building a Json::Value.
+ */
+
+#ifndef JSONSCANNER_H_
+#define JSONSCANNER_H_
+
+#include <string>
+#include <json/json.h>
+
+namespace jsonrpc
+{
+    /**
+     * A pull scanner over a JSON text, e.g. to decode the result of a response directly into typed variables:
+     *      scanner.BeginObject();
+     *      while (scanner.NextMember(name, length))
+     *          if (length == 1 && name[0] == 'x') scanner.Read(x); else scanner.Skip();
+     * Each method returns false if the next value does not have the expected type, the scanner does not move then,
+     * unless the text is malformed (see Failed). It is lenient about separators, it is meant for reading the output
+     * of JSON writers, not for validating JSON.
+     */
+    class JsonScanner
+    {
+        public:
+            JsonScanner();
+            JsonScanner(const char* data, size_t length);
+
+            /**
+             * Starts scanning another text, which has to stay valid while it is scanned.
+             */
+            void Reset(const char* data, size_t length);
+
+            /**
+             * Enters the object which is the next value.
+             */
+            bool BeginObject();
+
+            /**
+             * Moves to the value of the next member of the current object, it has to be read or skipped afterwards.
+             * @param name - points to the name of the member inside the text, escape sequences are not decoded.
+             * @return false after the last member, the scanner has left the object then.
+             */
+            bool NextMember(const char*& name, size_t& length);
+
+            /**
+             * Enters the array which is the next value.
+             */
+            bool BeginArray();
+
+            /**
+             * Moves to the next element of the current array, it has to be read or skipped afterwards.
+             * @return false after the last element, the scanner has left the array then.
+             */
+            bool NextElement();
+
+            /**
+             * Skips the next value if it is null.
+             */
+            bool IsNull();
+
+            bool Read(int& value);
+            bool Read(double& value);
+            bool Read(bool& value);
+            bool Read(std::string& value);
+
+            /**
+             * Reads the next value of any type, only this value is parsed into a Json::Value.
+             */
+            bool Read(Json::Value& value);
+
+            /**
+             * Skips the next value of any type.
+             */
+            bool Skip();
+
+            /**
+             * @return true if the text turned out to be malformed, all further calls fail then.
+             */
+            bool Failed() const;
+
+            /**
+             * @return true if the name returned by NextMember equals the given string.
+             */
+            static bool Matches(const char* name, size_t length, const char* expected);
+
+        private:
+            char Peek();
+            bool Fail();
+            bool ReadNumber(char* number, size_t size);
+            bool SkipString();
+
+            const char* data;
+            size_t length;
+            size_t position;
+            bool failed;
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONSCANNER_H_ */
@@ -0,0 +1,132 @@
+/**
+ * @file latencyhistogram.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Lock free histogram of latencies in nanoseconds.
+ */
+
+#include "latencyhistogram.h"
+#include <cstring>
+#include <time.h>
+
+namespace jsonrpc
+{
+    LatencyHistogram::LatencyHistogram()
+    {
+        this->Reset();
+    }
+
+    void LatencyHistogram::Record(uint64_t nanoseconds)
+    {
+        __sync_fetch_and_add(&this->buckets[GetBucketIndex(nanoseconds)], 1);
+        __sync_fetch_and_add(&this->count, 1);
+        __sync_fetch_and_add(&this->total, nanoseconds);
+
+        uint64_t current = this->max;
+        while (nanoseconds > current)
+        {
+            uint64_t previous = __sync_val_compare_and_swap(&this->max, current,
+                    nanoseconds);
+            if (previous == current)
+            {
+                break;
+            }
+            current = previous;
+        }
+    }
+
+    uint64_t LatencyHistogram::GetCount() const
+    {
+        return this->count;
+    }
+
+    uint64_t LatencyHistogram::GetTotal() const
+    {
+        return this->total;
+    }
+
+    uint64_t LatencyHistogram::GetMax() const
+    {
+        return this->max;
+    }
+
+    uint64_t LatencyHistogram::GetValueAtQuantile(double quantile) const
+    {
+        uint64_t count = 0;
+        for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        {
+            count += this->buckets[i];
+        }
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t rank = (uint64_t) (quantile * count + 0.5);
+        if (rank < 1)
+        {
+            rank = 1;
+        }
+        else if (rank > count)
+        {
+            rank = count;
+        }
+
+        uint64_t seen = 0;
+        for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        {
+            seen += this->buckets[i];
+            if (seen >= rank)
+            {
+                uint64_t value = GetBucketValue(i);
+                return value < this->max ? value : this->max;
+            }
+        }
+        return this->max;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        memset((void*) this->buckets, 0, sizeof(this->buckets));
+        this->count = 0;
+        this->total = 0;
+        this->max = 0;
+        __sync_synchronize();
+    }
+
+    uint64_t LatencyHistogram::Now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    unsigned int LatencyHistogram::GetBucketIndex(uint64_t value)
+    {
+        if (value < HISTOGRAM_SUB_BUCKETS)
+        {
+            return (unsigned int) value;
+        }
+        unsigned int exponent = 63 - __builtin_clzll(value);
+        if (exponent > HISTOGRAM_MAX_EXPONENT)
+        {
+            return HISTOGRAM_BUCKETS - 1;
+        }
+        unsigned int shift = exponent - HISTOGRAM_SUB_BUCKET_BITS;
+        return (shift + 1) * HISTOGRAM_SUB_BUCKETS
+                + (unsigned int) ((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+    }
+
+    uint64_t LatencyHistogram::GetBucketValue(unsigned int index)
+    {
+        if (index < HISTOGRAM_SUB_BUCKETS)
+        {
+            return index;
+        }
+        unsigned int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+        uint64_t lowest = (uint64_t) (HISTOGRAM_SUB_BUCKETS
+                + index % HISTOGRAM_SUB_BUCKETS) << shift;
+        return lowest + ((uint64_t) 1 << shift) - 1;
+    }
+
+} /* namespace jsonrpc */
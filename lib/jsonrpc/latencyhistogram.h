@@ -0,0 +1,75 @@
+/**
+ * @file latencyhistogram.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Lock free histogram of latencies in nanoseconds.
+ */
+
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <stdint.h>
+
+/**
+ * Each power of two is split into 2^HISTOGRAM_SUB_BUCKET_BITS buckets, so recorded values are exact to about 6%.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * Values of 2^HISTOGRAM_MAX_EXPONENT nanoseconds (about 9 minutes) and more end up in the last bucket.
+ */
+#define HISTOGRAM_MAX_EXPONENT 39
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_EXPONENT - HISTOGRAM_SUB_BUCKET_BITS + 2) * HISTOGRAM_SUB_BUCKETS)
+
+namespace jsonrpc
+{
+    /**
+     * This class records latencies into logarithmic buckets in the style of HdrHistogram. Recording is wait free
+     * (only atomic increments), so it can be done by all worker threads at the same time without locking.
+     * Readers may see a recording which is still in progress, quantiles are therefore approximations while
+     * requests are being processed.
+     */
+    class LatencyHistogram
+    {
+        public:
+            LatencyHistogram();
+
+            /**
+             * @param nanoseconds - the latency to record.
+             */
+            void Record(uint64_t nanoseconds);
+
+            uint64_t GetCount() const;
+            uint64_t GetTotal() const;
+            uint64_t GetMax() const;
+
+            /**
+             * @param quantile - between 0.0 and 1.0, e.g. 0.99 for the 99th percentile.
+             * @return the highest value which is equivalent (within the precision of the histogram) to the value at the
+             * given quantile, or 0 if nothing has been recorded yet.
+             */
+            uint64_t GetValueAtQuantile(double quantile) const;
+
+            /**
+             * Sets everything back to zero. Recordings which happen at the same time may get lost partly.
+             */
+            void Reset();
+
+            /**
+             * @return the current time of a monotonic clock in nanoseconds, to measure latencies with.
+             */
+            static uint64_t Now();
+
+        private:
+            static unsigned int GetBucketIndex(uint64_t value);
+            static uint64_t GetBucketValue(unsigned int index);
+
+            volatile uint64_t buckets[HISTOGRAM_BUCKETS];
+            volatile uint64_t count;
+            volatile uint64_t total;
+            volatile uint64_t max;
+    };
+
+} /* namespace jsonrpc */
+#endif /* LATENCYHISTOGRAM_H_ */
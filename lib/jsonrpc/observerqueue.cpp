@@ -0,0 +1,98 @@
+/**
+ * @file observerqueue.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Bounded lock free queue for observer events.
+ */
+
+#include "observerqueue.h"
+
+namespace jsonrpc
+{
+    ObserverQueue::ObserverQueue(size_t capacity)
+            : pushPosition(0), popPosition(0)
+    {
+        uint32_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        this->mask = size - 1;
+        this->slots = new observerslot_t[size];
+        for (uint32_t i = 0; i < size; i++)
+        {
+            this->slots[i].sequence = i;
+            this->slots[i].event.message = NULL;
+        }
+    }
+
+    ObserverQueue::~ObserverQueue()
+    {
+        delete[] this->slots;
+    }
+
+    bool ObserverQueue::Push(const observerevent_t& event)
+    {
+        uint32_t position = this->pushPosition;
+        while (true)
+        {
+            observerslot_t& slot = this->slots[position & this->mask];
+            int32_t difference = (int32_t) (slot.sequence - position);
+            if (difference == 0)
+            {
+                uint32_t previous = __sync_val_compare_and_swap(
+                        &this->pushPosition, position, position + 1);
+                if (previous == position)
+                {
+                    slot.event = event;
+                    //the event must be visible before the slot is released to the consumers
+                    __sync_synchronize();
+                    slot.sequence = position + 1;
+                    return true;
+                }
+                position = previous;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = this->pushPosition;
+            }
+        }
+    }
+
+    bool ObserverQueue::Pop(observerevent_t& event)
+    {
+        uint32_t position = this->popPosition;
+        while (true)
+        {
+            observerslot_t& slot = this->slots[position & this->mask];
+            int32_t difference = (int32_t) (slot.sequence - (position + 1));
+            if (difference == 0)
+            {
+                uint32_t previous = __sync_val_compare_and_swap(
+                        &this->popPosition, position, position + 1);
+                if (previous == position)
+                {
+                    __sync_synchronize();
+                    event = slot.event;
+                    __sync_synchronize();
+                    slot.sequence = position + this->mask + 1;
+                    return true;
+                }
+                position = previous;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = this->popPosition;
+            }
+        }
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,67 @@
+/**
+ * @file observerqueue.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Bounded lock free queue for observer events.
+ */
+
+#ifndef OBSERVERQUEUE_H_
+#define OBSERVERQUEUE_H_
+
+#include <stdint.h>
+#include <json/json.h>
+
+namespace jsonrpc
+{
+    /**
+     * A request or response which has to be delivered to the observers.
+     */
+    typedef struct
+    {
+            bool isResponse;
+            Json::Value* message;
+    } observerevent_t;
+
+    /**
+     * Bounded multi producer, multi consumer queue (after Dmitry Vyukov). Each slot carries a sequence number,
+     * so producers and consumers only need a single compare and swap on their index, and never block each other.
+     */
+    class ObserverQueue
+    {
+        public:
+            /**
+             * @param capacity - is rounded up to a power of two.
+             */
+            ObserverQueue(size_t capacity);
+            ~ObserverQueue();
+
+            /**
+             * @return false if the queue is full.
+             */
+            bool Push(const observerevent_t& event);
+
+            /**
+             * @return false if the queue is empty.
+             */
+            bool Pop(observerevent_t& event);
+
+        private:
+            typedef struct
+            {
+                    volatile uint32_t sequence;
+                    observerevent_t event;
+            } observerslot_t;
+
+            observerslot_t* slots;
+            uint32_t mask;
+
+            //producers and consumers work on different cache lines
+            char padding0[64];
+            volatile uint32_t pushPosition;
+            char padding1[64];
+            volatile uint32_t popPosition;
+            char padding2[64];
+    };
+
+} /* namespace jsonrpc */
+#endif /* OBSERVERQUEUE_H_ */
@@ -22,14 +22,39 @@ namespace jsonrpc
 
     Procedure::Procedure(const std::string& name,
             const procedure_t procedure_type, const parameterlist_t& parameters)
-            : procedureName(name), procedureType(procedure_type), parameters(
-                    parameters)
+            : procedureName(name), parameters(parameters), orderedParameters(
+                    parameters.begin(), parameters.end()), parameterDeclaration(
+                    PARAMS_BY_NAME), procedureType(procedure_type), hasReturnType(
+                    false), returnType(JSON_OBJECT), cacheTtl(0), references(0), retired(false)
     {
         this->procedurePointer.np = NULL;
         this->procedurePointer.rp = NULL;
+        this->streamPointer = NULL;
+        this->handler = NULL;
+        this->handlerId = 0;
+        this->validator = NULL;
+    }
+
+    Procedure::Procedure(const std::string& name,
+            const procedure_t procedure_type,
+            const orderedparameterlist_t& parameters)
+            : procedureName(name), parameters(parameters.begin(),
+                    parameters.end()), orderedParameters(parameters), parameterDeclaration(
+                    PARAMS_BY_POSITION), procedureType(procedure_type), hasReturnType(
+                    false), returnType(JSON_OBJECT), cacheTtl(0), references(0), retired(false)
+    {
+        this->procedurePointer.np = NULL;
+        this->procedurePointer.rp = NULL;
+        this->streamPointer = NULL;
+        this->handler = NULL;
+        this->handlerId = 0;
+        this->validator = NULL;
     }
 
     Procedure::Procedure(const Json::Value& signature)
+            : parameterDeclaration(PARAMS_BY_NAME), hasReturnType(false), returnType(
+                    JSON_OBJECT), cacheTtl(0), streamPointer(NULL), handler(NULL), handlerId(0), validator(
+                    NULL), references(0), retired(false)
     {
         if ((signature.isMember(KEY_METHOD_NAME)
                 || signature.isMember(KEY_NOTIFICATION_NAME))
@@ -47,41 +72,62 @@ namespace jsonrpc
                 this->procedureType = RPC_NOTIFICATION;
 
             }
+            const Json::Value& params = signature[KEY_PROCEDURE_PARAMETERS];
             if (signature[procedure_name].isString()
-                    && (signature[KEY_PROCEDURE_PARAMETERS].isObject() || signature[KEY_PROCEDURE_PARAMETERS].isNull()))
+                    && (params.isObject() || params.isArray() || params.isNull()))
             {
                 this->procedureName = signature[procedure_name].asString();
-                vector<string> parameters =
-                        signature[KEY_PROCEDURE_PARAMETERS].getMemberNames();
-                for (unsigned int i = 0; i < parameters.size(); i++)
+                if (params.isArray())
                 {
-                    switch (signature[KEY_PROCEDURE_PARAMETERS][parameters.at(i)].type())
+                    this->parameterDeclaration = PARAMS_BY_POSITION;
+                    for (unsigned int i = 0; i < params.size(); i++)
                     {
-                        case Json::uintValue:
-                        case Json::intValue:
-                            this->parameters[parameters.at(i)] = JSON_INTEGER;
-                            break;
-
-                        case Json::realValue:
-                            this->parameters[parameters.at(i)] = JSON_REAL;
-                            break;
-                        case Json::stringValue:
-                            this->parameters[parameters.at(i)] = JSON_STRING;
-                            break;
-                        case Json::booleanValue:
-                            this->parameters[parameters.at(i)] = JSON_BOOLEAN;
-                            break;
-                        case Json::arrayValue:
-                            this->parameters[parameters.at(i)] = JSON_ARRAY;
-                            break;
-                        case Json::objectValue:
-                            this->parameters[parameters.at(i)] = JSON_OBJECT;
-                            break;
-                        default:
+                        if (!params[i].isObject() || params[i].size() != 1)
+                        {
                             throw Exception(ERROR_PROCEDURE_PARSE_ERROR,
-                                    "Unknown parameter in "
+                                    "Positional parameters have to be declared as object with a single member: "
                                             + signature.toStyledString());
+                        }
+                        string name = params[i].begin().memberName();
+                        if (this->parameters.count(name) > 0)
+                        {
+                            throw Exception(ERROR_PROCEDURE_PARSE_ERROR,
+                                    "Duplicate parameter " + name + " in "
+                                            + signature.toStyledString());
+                        }
+                        this->parameters[name] = GetType(params[i][name], signature);
+                        this->orderedParameters.push_back(
+                                make_pair(name, this->parameters[name]));
+                    }
+                }
+                else
+                {
+                    vector<string> parameters = params.getMemberNames();
+                    for (unsigned int i = 0; i < parameters.size(); i++)
+                    {
+                        this->parameters[parameters.at(i)] = GetType(
+                                params[parameters.at(i)], signature);
+                    }
+                    this->orderedParameters.assign(this->parameters.begin(),
+                            this->parameters.end());
+                }
+                if (this->procedureType == RPC_METHOD
+                        && signature.isMember(KEY_RETURN_TYPE)
+                        && !signature[KEY_RETURN_TYPE].isNull())
+                {
+                    this->SetReturnType(
+                            GetType(signature[KEY_RETURN_TYPE], signature));
+                }
+                if (this->procedureType == RPC_METHOD
+                        && signature.isMember(KEY_CACHE_TTL))
+                {
+                    if (!signature[KEY_CACHE_TTL].isUInt())
+                    {
+                        throw Exception(ERROR_PROCEDURE_PARSE_ERROR,
+                                "The cache ttl has to be a number of milliseconds: "
+                                        + signature.toStyledString());
                     }
+                    this->cacheTtl = signature[KEY_CACHE_TTL].asUInt();
                 }
                 this->procedurePointer.np = NULL;
                 this->procedurePointer.rp = NULL;
@@ -101,46 +147,55 @@ namespace jsonrpc
         }
     }
 
+    Procedure::Procedure(const Procedure& other)
+            : procedureName(other.procedureName), parameters(other.parameters), orderedParameters(
+                    other.orderedParameters), parameterDeclaration(
+                    other.parameterDeclaration), procedureType(other.procedureType), hasReturnType(
+                    other.hasReturnType), returnType(other.returnType), cacheTtl(
+                    other.cacheTtl), procedurePointer(other.procedurePointer), streamPointer(
+                    other.streamPointer), handler(other.handler), handlerId(
+                    other.handlerId), validator(other.validator), references(0), retired(
+                    false)
+    {
+    }
+
     int Procedure::ValdiateParameters(const Json::Value& parameters)
     {
-        map<string, jsontype_t>::iterator it = this->parameters.begin();
-        bool ok = true;
-        while (ok == true && it != this->parameters.end())
+        if (this->validator != NULL)
+        {
+            return (*this->validator)(parameters);
+        }
+        if (parameters.isArray())
         {
-            if (!parameters.isMember(it->first.c_str()))
+            //positional params, which are not declared, are only accepted if they are empty
+            if (parameters.size() != this->orderedParameters.size()
+                    || (this->parameterDeclaration == PARAMS_BY_NAME
+                            && parameters.size() > 0))
             {
-                ok = false;
+                return ERROR_INVALID_PARAMS;
             }
-            else
+            for (unsigned int i = 0; i < parameters.size(); i++)
             {
-                switch (it->second)
+                if (!HasType(parameters[i], this->orderedParameters[i].second))
                 {
-                    case JSON_STRING:
-                        if (!parameters[it->first].isString())
-                            ok = false;
-                        break;
-                    case JSON_BOOLEAN:
-                        if (!parameters[it->first].isBool())
-                            ok = false;
-                        break;
-                    case JSON_INTEGER:
-                        if (!parameters[it->first].isInt())
-                            ok = false;
-                        break;
-                    case JSON_REAL:
-                        if (!parameters[it->first].isDouble())
-                            ok = false;
-                        break;
-                    case JSON_OBJECT:
-                        if (!parameters[it->first].isObject())
-                            ok = false;
-                        break;
-                    case JSON_ARRAY:
-                        if (!parameters[it->first].isArray())
-                            ok = false;
-                        break;
+                    return ERROR_INVALID_PARAMS;
                 }
             }
+            return ERROR_NO;
+        }
+        if (!parameters.isObject() && !this->parameters.empty())
+        {
+            return ERROR_INVALID_PARAMS;
+        }
+        map<string, jsontype_t>::iterator it = this->parameters.begin();
+        bool ok = true;
+        while (ok == true && it != this->parameters.end())
+        {
+            if (!parameters.isMember(it->first.c_str())
+                    || !HasType(parameters[it->first], it->second))
+            {
+                ok = false;
+            }
             it++;
         }
         if (ok == true)
@@ -153,16 +208,101 @@ namespace jsonrpc
         }
     }
 
+    void Procedure::SetValidator(pValidator_t validator)
+    {
+        this->validator = validator;
+    }
+
+    jsontype_t Procedure::GetType(const Json::Value& value,
+            const Json::Value& signature)
+    {
+        switch (value.type())
+        {
+            case Json::uintValue:
+            case Json::intValue:
+                return JSON_INTEGER;
+            case Json::realValue:
+                return JSON_REAL;
+            case Json::stringValue:
+                return JSON_STRING;
+            case Json::booleanValue:
+                return JSON_BOOLEAN;
+            case Json::arrayValue:
+                return JSON_ARRAY;
+            case Json::objectValue:
+                return JSON_OBJECT;
+            default:
+                throw Exception(ERROR_PROCEDURE_PARSE_ERROR,
+                        "Unknown parameter in " + signature.toStyledString());
+        }
+    }
+
+    bool Procedure::HasType(const Json::Value& value, jsontype_t type)
+    {
+        switch (type)
+        {
+            case JSON_STRING:
+                return value.isString();
+            case JSON_BOOLEAN:
+                return value.isBool();
+            case JSON_INTEGER:
+                return value.isInt();
+            case JSON_REAL:
+                return value.isDouble();
+            case JSON_OBJECT:
+                return value.isObject();
+            case JSON_ARRAY:
+                return value.isArray();
+        }
+        return false;
+    }
+
     const parameterlist_t& Procedure::GetParameters() const
     {
         return this->parameters;
     }
 
+    const orderedparameterlist_t& Procedure::GetOrderedParameters() const
+    {
+        return this->orderedParameters;
+    }
+
+    parameterdeclaration_t Procedure::GetParameterDeclaration() const
+    {
+        return this->parameterDeclaration;
+    }
+
     procedure_t Procedure::GetProcedureType() const
     {
         return this->procedureType;
     }
 
+    bool Procedure::HasReturnType() const
+    {
+        return this->hasReturnType;
+    }
+
+    jsontype_t Procedure::GetReturnType() const
+    {
+        return this->returnType;
+    }
+
+    void Procedure::SetReturnType(jsontype_t type)
+    {
+        this->hasReturnType = true;
+        this->returnType = type;
+    }
+
+    void Procedure::SetCacheTtl(unsigned int milliseconds)
+    {
+        this->cacheTtl = milliseconds;
+    }
+
+    unsigned int Procedure::GetCacheTtl() const
+    {
+        return this->cacheTtl;
+    }
+
     const std::string& jsonrpc::Procedure::GetProcedureName() const
     {
         return this->procedureName;
@@ -192,6 +332,11 @@ namespace jsonrpc
         }
     }
 
+    pStreamRequest_t Procedure::GetStreamPointer()
+    {
+        return this->streamPointer;
+    }
+
     bool Procedure::SetMethodPointer(pRequest_t rp)
     {
         if (this->procedureType == RPC_METHOD)
@@ -218,5 +363,44 @@ namespace jsonrpc
         }
     }
 
+    bool Procedure::SetStreamPointer(pStreamRequest_t srp)
+    {
+        if (this->procedureType == RPC_METHOD)
+        {
+            this->streamPointer = srp;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    void Procedure::SetHandler(ProcedureHandler* handler, int id)
+    {
+        this->handler = handler;
+        this->handlerId = id;
+    }
+
+    ProcedureHandler* Procedure::GetHandler()
+    {
+        return this->handler;
+    }
+
+    int Procedure::GetHandlerId() const
+    {
+        return this->handlerId;
+    }
+
+    CallMetrics& Procedure::GetMetrics()
+    {
+        return this->metrics;
+    }
+
+    const CallMetrics& Procedure::GetMetrics() const
+    {
+        return this->metrics;
+    }
+
 } /* namespace jsonrpc */
 
@@ -10,8 +10,12 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <json/json.h>
 
+#include "resultstream.h"
+#include "callmetrics.h"
+
 /**
  * String literal for describing type string in the json-description file.
  */
@@ -46,6 +50,8 @@
 #define KEY_METHOD_NAME "method"
 #define KEY_NOTIFICATION_NAME "notification"
 #define KEY_PROCEDURE_PARAMETERS "params"
+#define KEY_RETURN_TYPE "returns"
+#define KEY_CACHE_TTL "cache"
 
 namespace jsonrpc
 {
@@ -84,8 +90,36 @@ namespace jsonrpc
      */
     typedef void (*pNotification_t)(const Json::Value&);
 
+    /**
+     * Type declaration signature of a streaming Method, which appends its result array element by element.
+     * e.g. void exportSomething(const Json::Value& parameter, ResultStream& result);
+     */
+    typedef void (*pStreamRequest_t)(const Json::Value&, ResultStream&);
+
+    /**
+     * Type declaration signature of a compiled parameter validator, e.g. generated by jsonrpcstub.
+     * It has to return the same result as Procedure::ValdiateParameters.
+     */
+    typedef int (*pValidator_t)(const Json::Value&);
+
+    /**
+     * This enum describes whether the params of a procedure are declared as object (by name) or as array (by position).
+     */
+    typedef enum
+    {
+        PARAMS_BY_NAME, PARAMS_BY_POSITION
+    } parameterdeclaration_t;
+
     typedef std::map<std::string, jsontype_t> parameterlist_t;
 
+    /**
+     * Parameters in the order of their declaration.
+     */
+    typedef std::vector<std::pair<std::string, jsontype_t> > orderedparameterlist_t;
+
+    class ProcedureHandler;
+    class ProcedureRegistry;
+
     class Procedure
     {
         public:
@@ -97,6 +131,12 @@ namespace jsonrpc
              */
             Procedure(const std::string &name, const procedure_t procedure_type, const parameterlist_t &parameters);
 
+            /**
+             * Declares a procedure whose params are passed by position, in the order of the list.
+             * Its params may still be passed by name as well.
+             */
+            Procedure(const std::string &name, const procedure_t procedure_type, const orderedparameterlist_t &parameters);
+
             /**
              * @param signature - Is a JSON-Value from which each procedure can parse itself. The parameter should have the following format:
              *      e.g. {
@@ -112,9 +152,20 @@ namespace jsonrpc
              *  please note, that you'll have to provide a valid "parameters" array, otherwise an Exception of type JsonRpcException will be thrown.
              *  The params Object looks a bit confusing. The Key of each paramArray Entry is the name of the parameter. The JSON-Value behind is only needed for parsing the right type.
              *  This could be any appropriate literal, it doesn't matter.
+             *  Methods may declare the type of their result the same way, e.g. "returns" : 0 for an integer.
+             *
+             *  Positional params are declared as array of objects with a single member each, in the order of the positions:
+             *      e.g. "params": [ { "name" : "some literal" }, { "price" : 0.0 } ]
+             *  Idempotent methods may allow caching their results for some milliseconds, e.g. "cache" : 500 (see SetCacheTtl).
              */
             Procedure(const Json::Value &signature);
 
+            /**
+             * Copies the declaration, settings and bindings of a procedure, e.g. to change them while the original is
+             * being called (see ProcedureRegistry::Transaction). The metrics of the copy start at zero.
+             */
+            Procedure(const Procedure& other);
+
 
             ~Procedure();
 
@@ -125,11 +176,40 @@ namespace jsonrpc
              * @return 0 on successful validation a negative errorcode otherwise.
              *
              * If the valid parameters are of Type JSON_ARRAY or JSON_OBJECT, they can only be checked for name and not for their structure.
+             * Positional params (an array) are checked by index and are only accepted if the procedure declares its parameters by position.
+             * If a validator has been set, it is called instead.
              */
             int ValdiateParameters(const Json::Value &parameters);
 
+            /**
+             * Replaces the validation against the parameterlist with a compiled validator.
+             */
+            void SetValidator(pValidator_t validator);
+
             const parameterlist_t& GetParameters() const;
+
+            /**
+             * @return the parameters in the order of their positions, procedures declared by name keep them sorted by name.
+             */
+            const orderedparameterlist_t& GetOrderedParameters() const;
+            parameterdeclaration_t GetParameterDeclaration() const;
             procedure_t GetProcedureType() const;
+
+            /**
+             * @return false if the type of the result has not been declared, it can be anything then.
+             */
+            bool HasReturnType() const;
+            jsontype_t GetReturnType() const;
+            void SetReturnType(jsontype_t type);
+
+            /**
+             * Results of this method are cached by the RequestHandler for the given time (if its response cache is enabled),
+             * equal calls within this time are answered with the cached result, without calling the method again.
+             * @param milliseconds - 0 (default) disables caching.
+             */
+            void SetCacheTtl(unsigned int milliseconds);
+            unsigned int GetCacheTtl() const;
+
             const std::string& GetProcedureName() const;
 
             /**
@@ -146,6 +226,11 @@ namespace jsonrpc
              */
             pNotification_t GetNotificationPointer();
 
+            /**
+             * @return returns a pointer to the corresponding streaming function, or NULL if the method does not stream its result.
+             */
+            pStreamRequest_t GetStreamPointer();
+
             /**
              * sets in case of an Method the methodPointer
              * @return false if this procedure is not declared as Method.
@@ -158,6 +243,30 @@ namespace jsonrpc
              */
             bool SetNotificationPointer(pNotification_t np);
 
+            /**
+             * sets in case of an Method the pointer to a streaming function. It is called instead of the methodPointer.
+             * @return false if this procedure is not declared as Method.
+             */
+            bool SetStreamPointer(pStreamRequest_t srp);
+
+            /**
+             * Binds this procedure to a handler object, which is called instead of the method or notification pointer.
+             * @param id - is passed back to the handler (see GetHandlerId), to tell its procedures apart.
+             */
+            void SetHandler(ProcedureHandler* handler, int id);
+
+            /**
+             * @return the handler of this procedure, or NULL if its method or notification pointer is called.
+             */
+            ProcedureHandler* GetHandler();
+            int GetHandlerId() const;
+
+            /**
+             * @return call counters and latency histograms of this procedure, they are recorded by the RequestHandler.
+             */
+            CallMetrics& GetMetrics();
+            const CallMetrics& GetMetrics() const;
+
         private:
             /**
              * Each Procedure should have a name.
@@ -168,11 +277,17 @@ namespace jsonrpc
              * The string represents the name of each parameter and JsonType the type it should have.
              */
             parameterlist_t parameters;
+            orderedparameterlist_t orderedParameters;
+            parameterdeclaration_t parameterDeclaration;
             /**
              * defines whether the procedure is a real procedure or just a notification
              */
             procedure_t procedureType;
 
+            bool hasReturnType;
+            jsontype_t returnType;
+            unsigned int cacheTtl;
+
             /**
              * Because we can't decide at first whether it is a method or notification procedure, we have to keep the function Pointer as a union.
              * To get the right method pointer, one has to call getProcedureType to clarify which kind of procedure it is. After that the correspoinding getMethodPointer
@@ -183,6 +298,31 @@ namespace jsonrpc
                     pRequest_t rp;
                     pNotification_t np;
             } procedurePointer;
+
+            pStreamRequest_t streamPointer;
+
+            ProcedureHandler* handler;
+            int handlerId;
+
+            pValidator_t validator;
+
+            CallMetrics metrics;
+
+            /**
+             * Maintained by the ProcedureRegistry, which deletes the procedure with its last reference.
+             */
+            volatile int references;
+            volatile bool retired;
+            friend class ProcedureRegistry;
+
+            Procedure& operator=(const Procedure& other);
+
+            /**
+             * @return the type of a literal of the json-description file.
+             */
+            static jsontype_t GetType(const Json::Value& value, const Json::Value& signature);
+
+            static bool HasType(const Json::Value& value, jsontype_t type);
     };
 
 } /* namespace jsonrpc */
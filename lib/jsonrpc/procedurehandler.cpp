@@ -0,0 +1,43 @@
+/**
+ * @file procedurehandler.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Interface for objects which handle the calls of several procedures, e.g. generated server stubs.
+ */
+
+#include "procedurehandler.h"
+
+namespace jsonrpc
+{
+    void ProcedureHandler::GetArguments(const Procedure& procedure,
+            const Json::Value& parameter, const Json::Value** arguments)
+    {
+        const orderedparameterlist_t& parameters =
+                procedure.GetOrderedParameters();
+        if (parameter.isArray())
+        {
+            for (unsigned int i = 0; i < parameters.size(); i++)
+            {
+                arguments[i] = &parameter[i];
+            }
+        }
+        else if (procedure.GetParameterDeclaration() == PARAMS_BY_NAME
+                && parameter.size() == parameters.size())
+        {
+            //json objects keep their members sorted by name, just like the parameters of procedures declared by name
+            Json::Value::const_iterator it = parameter.begin();
+            for (size_t i = 0; i < parameters.size(); i++, it++)
+            {
+                arguments[i] = &(*it);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < parameters.size(); i++)
+            {
+                arguments[i] = &parameter[parameters[i].first];
+            }
+        }
+    }
+
+} /* namespace jsonrpc */
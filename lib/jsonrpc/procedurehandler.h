@@ -0,0 +1,60 @@
+/**
+ * @file procedurehandler.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Interface for objects which handle the calls of several procedures, e.g. generated server stubs.
+ */
+
+#ifndef PROCEDUREHANDLER_H_
+#define PROCEDUREHANDLER_H_
+
+#include <json/json.h>
+
+#include "procedure.h"
+
+namespace jsonrpc
+{
+    /**
+     * A ProcedureHandler is bound to one or more procedures with Procedure::SetHandler, and is called instead
+     * of their method or notification pointers. The id passed to SetHandler tells the procedures apart without comparing names.
+     */
+    class ProcedureHandler
+    {
+        public:
+            virtual ~ProcedureHandler()
+            {
+            }
+
+            /**
+             * @param procedure - the called procedure, its parameters have already been validated.
+             * @param parameter - the params of the request.
+             * @param result - will be sent as result of the call.
+             */
+            virtual void HandleMethodCall(Procedure& procedure,
+                    const Json::Value& parameter, Json::Value& result) = 0;
+
+            virtual void HandleNotificationCall(Procedure& procedure,
+                    const Json::Value& parameter) = 0;
+
+            /**
+             * Procedures are only bound to handlers which can handle their type.
+             * @return true by default, handlers which only handle methods or only notifications override this.
+             */
+            virtual bool Handles(procedure_t) const
+            {
+                return true;
+            }
+
+            /**
+             * Looks up the arguments of a call in the order of Procedure::GetOrderedParameters.
+             * Positional params are taken by index. If named params contain exactly the parameters of a procedure declared by name,
+             * they are already stored in this order and are taken one after another without searching for their names.
+             * @pre the parameters have been validated by the procedure.
+             * @param arguments - must have room for one pointer per parameter of the procedure.
+             */
+            static void GetArguments(const Procedure& procedure,
+                    const Json::Value& parameter, const Json::Value** arguments);
+    };
+
+} /* namespace jsonrpc */
+#endif /* PROCEDUREHANDLER_H_ */
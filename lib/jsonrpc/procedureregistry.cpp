@@ -0,0 +1,227 @@
+/**
+ * @file procedureregistry.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Copy on write table of procedures, which is read without locks.
+ */
+
+#include "procedureregistry.h"
+
+#include <set>
+#include <sched.h>
+#include <string.h>
+
+using namespace std;
+
+namespace jsonrpc
+{
+    ProcedureRegistry::Transaction::Transaction(ProcedureRegistry& registry)
+            : registry(registry), committed(false)
+    {
+        pthread_mutex_lock(&registry.writeLock);
+        this->table = new procedurelist_t(*registry.table);
+    }
+
+    ProcedureRegistry::Transaction::~Transaction()
+    {
+        if (!this->committed)
+        {
+            delete this->table;
+        }
+        pthread_mutex_unlock(&this->registry.writeLock);
+    }
+
+    procedurelist_t& ProcedureRegistry::Transaction::GetProcedures()
+    {
+        return *this->table;
+    }
+
+    void ProcedureRegistry::Transaction::Commit()
+    {
+        if (!this->committed)
+        {
+            this->committed = true;
+            this->registry.Publish(this->table);
+        }
+    }
+
+    ProcedureRegistry::ProcedureRegistry()
+            : table(new procedurelist_t()), epoch(0)
+    {
+        memset((void*) this->slots, 0, sizeof(this->slots));
+        pthread_mutex_init(&this->writeLock, NULL);
+    }
+
+    ProcedureRegistry::~ProcedureRegistry()
+    {
+        for (procedurelist_t::iterator it = this->table->begin();
+                it != this->table->end(); it++)
+        {
+            it->second->retired = true;
+            this->Release(it->second);
+        }
+        delete this->table;
+        pthread_mutex_destroy(&this->writeLock);
+    }
+
+    int ProcedureRegistry::Enter()
+    {
+        //pthread_t is the address of the thread descriptor on linux, its low bits are always the same
+        unsigned int slot = ((unsigned int) (size_t) pthread_self() * 2654435761u)
+                % PROCEDURE_REGISTRY_SLOTS;
+        int parity = this->epoch;
+        //the increment is a full barrier, the table is read after it
+        __sync_fetch_and_add(&this->slots[slot].readers[parity], 1);
+        return slot * 2 + parity;
+    }
+
+    void ProcedureRegistry::Leave(int token)
+    {
+        __sync_fetch_and_sub(&this->slots[token / 2].readers[token % 2], 1);
+    }
+
+    const procedurelist_t& ProcedureRegistry::GetProcedures() const
+    {
+        return *this->table;
+    }
+
+    Procedure* ProcedureRegistry::Find(const std::string& name) const
+    {
+        const procedurelist_t& procedures = *this->table;
+        procedurelist_t::const_iterator it = procedures.find(name);
+        if (it != procedures.end())
+        {
+            return it->second;
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+
+    Procedure* ProcedureRegistry::Acquire(const std::string& name)
+    {
+        ReadSection section(*this);
+        Procedure* procedure = this->Find(name);
+        if (procedure != NULL && !this->Acquire(procedure))
+        {
+            procedure = NULL;
+        }
+        return procedure;
+    }
+
+    bool ProcedureRegistry::Acquire(Procedure* procedure)
+    {
+        //the increment is a full barrier: a writer, which retires the procedure afterwards, releases its own reference later on
+        __sync_fetch_and_add(&procedure->references, 1);
+        if (procedure->retired)
+        {
+            this->Release(procedure);
+            return false;
+        }
+        return true;
+    }
+
+    void ProcedureRegistry::Release(Procedure* procedure)
+    {
+        if (__sync_sub_and_fetch(&procedure->references, 1) == 0)
+        {
+            delete procedure;
+        }
+    }
+
+    bool ProcedureRegistry::Add(Procedure* procedure)
+    {
+        if (procedure == NULL)
+        {
+            return false;
+        }
+        Transaction transaction(*this);
+        transaction.GetProcedures()[procedure->GetProcedureName()] = procedure;
+        transaction.Commit();
+        return true;
+    }
+
+    bool ProcedureRegistry::Remove(const std::string& name)
+    {
+        Transaction transaction(*this);
+        bool found = transaction.GetProcedures().erase(name) > 0;
+        if (found)
+        {
+            transaction.Commit();
+        }
+        return found;
+    }
+
+    void ProcedureRegistry::Replace(const procedurelist_t& procedures)
+    {
+        Transaction transaction(*this);
+        transaction.GetProcedures() = procedures;
+        transaction.Commit();
+    }
+
+    void ProcedureRegistry::Publish(procedurelist_t* table)
+    {
+        procedurelist_t* old = this->table;
+        set<Procedure*> published, retired;
+        for (procedurelist_t::iterator it = table->begin(); it != table->end();
+                it++)
+        {
+            published.insert(it->second);
+        }
+        for (procedurelist_t::iterator it = old->begin(); it != old->end(); it++)
+        {
+            if (published.erase(it->second) == 0)
+            {
+                retired.insert(it->second);
+            }
+        }
+
+        //the registry holds one reference of each procedure in its table
+        for (set<Procedure*>::iterator it = published.begin();
+                it != published.end(); it++)
+        {
+            __sync_fetch_and_add(&(*it)->references, 1);
+            (*it)->retired = false;
+        }
+
+        //the new table has to be complete before readers can see it
+        __sync_synchronize();
+        this->table = table;
+        this->Synchronize();
+        //Readers of the old table have acquired its procedures by now. Retiring them earlier would make
+        //those readers miss a replaced procedure, although its replacement has already been published.
+        for (set<Procedure*>::iterator it = retired.begin(); it != retired.end();
+                it++)
+        {
+            (*it)->retired = true;
+            this->Release(*it);
+        }
+        delete old;
+    }
+
+    void ProcedureRegistry::Synchronize()
+    {
+        //A reader may have read the epoch before the first switch and increment its counter only afterwards.
+        //Waiting for both epochs guarantees that it is either waited for, or sees the new table.
+        for (int phase = 0; phase < 2; phase++)
+        {
+            int parity = this->epoch;
+            __sync_synchronize();
+            this->epoch = parity ^ 1;
+            __sync_synchronize();
+            for (int slot = 0; slot < PROCEDURE_REGISTRY_SLOTS;)
+            {
+                if (this->slots[slot].readers[parity] > 0)
+                {
+                    sched_yield();
+                }
+                else
+                {
+                    slot++;
+                }
+            }
+        }
+    }
+
+} /* namespace jsonrpc */
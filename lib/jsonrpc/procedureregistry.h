@@ -0,0 +1,183 @@
+/**
+ * @file procedureregistry.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Copy on write table of procedures, which is read without locks.
+ */
+
+#ifndef PROCEDUREREGISTRY_H_
+#define PROCEDUREREGISTRY_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "procedure.h"
+
+/**
+ * Number of reader counters, threads are spread over them to avoid contention on a single cache line.
+ */
+#define PROCEDURE_REGISTRY_SLOTS 16
+
+namespace jsonrpc
+{
+    typedef std::map<std::string, Procedure*> procedurelist_t;
+
+    /**
+     * Holds the procedures of a RequestHandler in an immutable table. Each change copies the table and publishes
+     * the copy with a single pointer store, so readers never lock and always see a consistent table.
+     *
+     * Readers announce themselves with Enter (an atomic increment of a counter of the current epoch) and Leave.
+     * After publishing, a writer switches the epoch twice and waits each time until the counters of the previous
+     * epoch drop to zero. Then no reader can see the old table anymore, and it is deleted.
+     *
+     * Read sections are only held for lookups, a procedure which is used longer (e.g. while it is called) is kept
+     * alive by a reference (see Acquire). Removed procedures are deleted when their last reference is released,
+     * so writers never wait for running calls, and procedures may add or remove procedures themselves.
+     */
+    class ProcedureRegistry
+    {
+        public:
+            /**
+             * Enters a read section for its lifetime.
+             */
+            class ReadSection
+            {
+                public:
+                    ReadSection(ProcedureRegistry& registry)
+                            : registry(registry), token(registry.Enter())
+                    {
+                    }
+                    ~ReadSection()
+                    {
+                        this->registry.Leave(this->token);
+                    }
+
+                private:
+                    ProcedureRegistry& registry;
+                    int token;
+            };
+
+            /**
+             * Changes a copy of the table, which is published by Commit. Writers are serialized, the table can't
+             * be changed by anyone else during the lifetime of a transaction, so it may be read without a read section.
+             * A transaction which has not been committed is discarded by the destructor.
+             */
+            class Transaction
+            {
+                public:
+                    Transaction(ProcedureRegistry& registry);
+                    ~Transaction();
+
+                    /**
+                     * @return the copy of the table. Procedures must not be changed in place while they are part of the
+                     * registry (workers may be calling them), they are replaced by changed copies instead.
+                     */
+                    procedurelist_t& GetProcedures();
+
+                    /**
+                     * Publishes the table, the registry takes ownership of the procedures which have been added.
+                     * Procedures which are not part of the table anymore are deleted once they are released by everyone.
+                     */
+                    void Commit();
+
+                private:
+                    ProcedureRegistry& registry;
+                    procedurelist_t* table;
+                    bool committed;
+            };
+
+            ProcedureRegistry();
+
+            /**
+             * Releases all procedures.
+             */
+            ~ProcedureRegistry();
+
+            /**
+             * Starts a read section, the table and its procedures stay valid until Leave. Never blocks, sections may be nested.
+             * @return the token for Leave.
+             */
+            int Enter();
+            void Leave(int token);
+
+            /**
+             * @return the current table, it must only be used inside a read section while procedures may change concurrently.
+             */
+            const procedurelist_t& GetProcedures() const;
+
+            /**
+             * @return the procedure with this name or NULL, it must only be used inside a read section while procedures may change concurrently.
+             */
+            Procedure* Find(const std::string& name) const;
+
+            /**
+             * @return the procedure with this name, with a reference which has to be given back with Release, or NULL.
+             */
+            Procedure* Acquire(const std::string& name);
+
+            /**
+             * Takes a reference of a procedure, if it is still part of the table.
+             * @pre procedure can't be deleted meanwhile, e.g. because it has been found inside the current read section.
+             * @return false if it has been removed.
+             */
+            bool Acquire(Procedure* procedure);
+
+            /**
+             * Gives a reference back, the procedure is deleted if it has been removed and this was the last one.
+             */
+            void Release(Procedure* procedure);
+
+            /**
+             * The following methods change the table, like a Transaction. They block until no read section can see
+             * the old table anymore, and must therefore not be called inside a read section of the same thread.
+             */
+
+            /**
+             * Adds a procedure, a procedure with the same name is replaced and released.
+             * @return false if procedure is NULL.
+             */
+            bool Add(Procedure* procedure);
+
+            /**
+             * Removes and releases a procedure.
+             * @return false if there is no procedure with this name.
+             */
+            bool Remove(const std::string& name);
+
+            /**
+             * Replaces the whole table at once, the registry takes ownership of the new procedures.
+             * Procedures of the old table, which are not part of the new one, are released.
+             */
+            void Replace(const procedurelist_t& procedures);
+
+        private:
+            /**
+             * Each counter lies on its own cache line.
+             */
+            typedef struct
+            {
+                    volatile int readers[2];
+                    char padding[64 - 2 * sizeof(int)];
+            } readerslot_t;
+
+            /**
+             * Swaps in the new table, deletes the old one after the grace period and releases the procedures which are not part of it anymore.
+             * @pre writeLock is held.
+             */
+            void Publish(procedurelist_t* table);
+
+            /**
+             * Waits until all read sections, which have been entered before, have been left.
+             */
+            void Synchronize();
+
+            procedurelist_t* volatile table;
+            volatile int epoch;
+            readerslot_t slots[PROCEDURE_REGISTRY_SLOTS];
+            pthread_mutex_t writeLock;
+    };
+
+} /* namespace jsonrpc */
+#endif /* PROCEDUREREGISTRY_H_ */
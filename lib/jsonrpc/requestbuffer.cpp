@@ -0,0 +1,162 @@
+/**
+ * @file requestbuffer.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Serializes requests directly from typed arguments into a reusable buffer.
+ */
+
+#include "requestbuffer.h"
+#include "requesthandler.h"
+
+using namespace std;
+
+namespace jsonrpc
+{
+    RequestBuffer::RequestBuffer()
+            : numParameters(0), positional(false)
+    {
+    }
+
+    void RequestBuffer::Begin(const std::string& name, int id, bool positional)
+    {
+        //clear() keeps the capacity of the buffer
+        this->buffer.clear();
+        this->buffer += "{\"" KEY_REQUEST_VERSION "\":\"" JSON_RPC_VERSION "\",\"" KEY_REQUEST_METHODNAME "\":";
+        Append(this->buffer, name);
+        if (id > 0)
+        {
+            this->buffer += ",\"" KEY_REQUEST_ID "\":";
+            Append(this->buffer, id);
+        }
+        this->buffer += ",\"" KEY_REQUEST_PARAMETERS "\":";
+        this->numParameters = 0;
+        this->positional = positional;
+    }
+
+    void RequestBuffer::AddParameter(const char* name, int value)
+    {
+        this->AppendName(name);
+        Append(this->buffer, value);
+    }
+
+    void RequestBuffer::AddParameter(const char* name, double value)
+    {
+        this->AppendName(name);
+        Append(this->buffer, value);
+    }
+
+    void RequestBuffer::AddParameter(const char* name, bool value)
+    {
+        this->AppendName(name);
+        Append(this->buffer, value);
+    }
+
+    void RequestBuffer::AddParameter(const char* name, const char* value)
+    {
+        this->AppendName(name);
+        Append(this->buffer, value);
+    }
+
+    void RequestBuffer::AddParameter(const char* name, const std::string& value)
+    {
+        this->AppendName(name);
+        Append(this->buffer, value);
+    }
+
+    void RequestBuffer::AddParameter(const char* name, const Json::Value& value)
+    {
+        this->AppendName(name);
+        Append(this->buffer, value);
+    }
+
+    std::string& RequestBuffer::BeginParameter(const char* name)
+    {
+        this->AppendName(name);
+        return this->buffer;
+    }
+
+    const std::string& RequestBuffer::End()
+    {
+        if (this->numParameters == 0)
+        {
+            this->buffer += this->positional ? "[]}" : "null}";
+        }
+        else
+        {
+            this->buffer += this->positional ? "]}" : "}}";
+        }
+        return this->buffer;
+    }
+
+    void RequestBuffer::AppendName(const char* name)
+    {
+        if (this->positional)
+        {
+            this->buffer += this->numParameters++ == 0 ? '[' : ',';
+        }
+        else
+        {
+            this->buffer += this->numParameters++ == 0 ? '{' : ',';
+            Append(this->buffer, name);
+            this->buffer += ':';
+        }
+    }
+
+    void RequestBuffer::Append(std::string& buffer, int value)
+    {
+        char digits[16];
+        char* p = digits + sizeof(digits);
+        unsigned int u = value < 0 ? 0u - (unsigned int) value : value;
+        do
+        {
+            *--p = '0' + u % 10;
+            u /= 10;
+        } while (u != 0);
+        if (value < 0)
+        {
+            *--p = '-';
+        }
+        buffer.append(p, digits + sizeof(digits) - p);
+    }
+
+    void RequestBuffer::Append(std::string& buffer, double value)
+    {
+        buffer += Json::valueToString(value);
+    }
+
+    void RequestBuffer::Append(std::string& buffer, bool value)
+    {
+        buffer += value ? "true" : "false";
+    }
+
+    void RequestBuffer::Append(std::string& buffer, const char* value)
+    {
+        buffer += Json::valueToQuotedString(value);
+    }
+
+    void RequestBuffer::Append(std::string& buffer, const std::string& value)
+    {
+        //strings without characters to escape are copied directly
+        for (size_t i = 0; i < value.length(); i++)
+        {
+            unsigned char c = value[i];
+            if (c < 0x20 || c == '"' || c == '\\')
+            {
+                buffer += Json::valueToQuotedString(value.c_str());
+                return;
+            }
+        }
+        buffer += '"';
+        buffer += value;
+        buffer += '"';
+    }
+
+    void RequestBuffer::Append(std::string& buffer, const Json::Value& value)
+    {
+        Json::FastWriter writer;
+        string json = writer.write(value);
+        //FastWriter terminates the document with a newline
+        buffer.append(json, 0, json.length() - 1);
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,72 @@
+/**
+ * @file requestbuffer.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Serializes requests directly from typed arguments into a reusable buffer.
+ */
+
+#ifndef REQUESTBUFFER_H_
+#define REQUESTBUFFER_H_
+
+#include <string>
+#include <json/json.h>
+
+namespace jsonrpc
+{
+    /**
+     * Writes a request without building a Json::Value first, e.g. for stubs generated by jsonrpcstub:
+     *      buffer.Begin("sayHello", 1);
+     *      buffer.AddParameter("name", name);
+     *      connector->SendMessage(buffer.End());
+     * The memory of the buffer is kept for the next request.
+     */
+    class RequestBuffer
+    {
+        public:
+            RequestBuffer();
+
+            /**
+             * Starts a new request.
+             * @param id - the id of a method call, notifications are written without id if id <= 0.
+             * @param positional - if true, the params are written as array in the order they are added, their names are ignored.
+             */
+            void Begin(const std::string& name, int id, bool positional = false);
+
+            void AddParameter(const char* name, int value);
+            void AddParameter(const char* name, double value);
+            void AddParameter(const char* name, bool value);
+            void AddParameter(const char* name, const char* value);
+            void AddParameter(const char* name, const std::string& value);
+            void AddParameter(const char* name, const Json::Value& value);
+
+            /**
+             * Starts a parameter whose value is appended directly to the returned buffer, e.g. by generated structs.
+             */
+            std::string& BeginParameter(const char* name);
+
+            /**
+             * Closes the request, parameters can only be added after the next call of Begin.
+             * @return the complete request.
+             */
+            const std::string& End();
+
+            /**
+             * These append a single JSON value to a buffer.
+             */
+            static void Append(std::string& buffer, int value);
+            static void Append(std::string& buffer, double value);
+            static void Append(std::string& buffer, bool value);
+            static void Append(std::string& buffer, const char* value);
+            static void Append(std::string& buffer, const std::string& value);
+            static void Append(std::string& buffer, const Json::Value& value);
+
+        private:
+            void AppendName(const char* name);
+
+            std::string buffer;
+            int numParameters;
+            bool positional;
+    };
+
+} /* namespace jsonrpc */
+#endif /* REQUESTBUFFER_H_ */
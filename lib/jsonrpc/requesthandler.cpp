@@ -7,6 +7,11 @@
 
 #include "requesthandler.h"
 #include "errors.h"
+#include "procedurehandler.h"
+#include "requestbuffer.h"
+#include "tracer.h"
+#include <sched.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -30,17 +35,37 @@ namespace jsonrpc
     }
 
     RequestHandler::RequestHandler(const std::string& instanceName)
-            : instanceName(instanceName), authManager(NULL)
+            : instanceName(instanceName), numRequestObservers(0), numResponseObservers(
+                    0), observerQueue(OBSERVER_QUEUE_SIZE), observerWaiting(0), observerThreadRunning(
+                    false), stopObservers(false), dropPolicy(DROP_NEWEST), queuedObserverEvents(
+                    0), processedObserverEvents(0), droppedObserverEvents(0), procedureLookup(
+                    NULL), procedureLookupData(NULL), authManager(NULL)
     {
+        pthread_mutex_init(&this->observerLock, NULL);
+        pthread_mutex_init(&this->observerWaitLock, NULL);
+        pthread_cond_init(&this->observerEvents, NULL);
     }
 
     RequestHandler::~RequestHandler()
     {
-        for (map<string, Procedure*>::iterator it = this->procedures.begin();
-                it != this->procedures.end(); it++)
+        if (this->observerThreadRunning)
         {
-            delete it->second;
+            //the observer thread delivers everything which is still queued before it stops.
+            this->stopObservers = true;
+            pthread_mutex_lock(&this->observerWaitLock);
+            pthread_cond_signal(&this->observerEvents);
+            pthread_mutex_unlock(&this->observerWaitLock);
+            pthread_join(this->observerThread, NULL);
         }
+        observerevent_t event;
+        while (this->observerQueue.Pop(event))
+        {
+            delete event.message;
+        }
+        pthread_cond_destroy(&this->observerEvents);
+        pthread_mutex_destroy(&this->observerWaitLock);
+        pthread_mutex_destroy(&this->observerLock);
+
         if (this->authManager != NULL)
         {
             delete this->authManager;
@@ -49,6 +74,7 @@ namespace jsonrpc
 
     void RequestHandler::AddObserver(observerFunction fp, observer_t t)
     {
+        pthread_mutex_lock(&this->observerLock);
         switch (t)
         {
             case ON_REQUEST:
@@ -62,10 +88,20 @@ namespace jsonrpc
                 this->responseObservers.push_back(fp);
                 break;
         }
+        this->numRequestObservers = this->requestObservers.size();
+        this->numResponseObservers = this->responseObservers.size();
+
+        if (!this->observerThreadRunning)
+        {
+            this->observerThreadRunning = pthread_create(&this->observerThread,
+                    NULL, &RequestHandler::DeliverObservations, this) == 0;
+        }
+        pthread_mutex_unlock(&this->observerLock);
     }
 
     void RequestHandler::RemoveObserver(observerFunction fp)
     {
+        pthread_mutex_lock(&this->observerLock);
         bool found = false;
         unsigned int i = 0;
         while (found == false && i < this->requestObservers.size())
@@ -82,6 +118,7 @@ namespace jsonrpc
             }
         }
         found = false;
+        i = 0;
         while (found == false && i < this->responseObservers.size())
         {
             if (this->responseObservers.at(i) == fp)
@@ -95,33 +132,67 @@ namespace jsonrpc
                 i++;
             }
         }
+        this->numRequestObservers = this->requestObservers.size();
+        this->numResponseObservers = this->responseObservers.size();
+        pthread_mutex_unlock(&this->observerLock);
     }
 
-    bool RequestHandler::AddProcedure(Procedure* procedure)
+    void RequestHandler::SetObserverDropPolicy(droppolicy_t policy)
     {
-        if (procedure != NULL)
-        {
-            this->procedures[procedure->GetProcedureName()] = procedure;
-            return true;
-        }
-        else
+        this->dropPolicy = policy;
+    }
+
+    uint64_t RequestHandler::GetDroppedObserverEvents() const
+    {
+        return this->droppedObserverEvents;
+    }
+
+    void RequestHandler::FlushObservers()
+    {
+        while (this->observerThreadRunning
+                && this->processedObserverEvents < this->queuedObserverEvents)
         {
-            return false;
+            usleep(100);
         }
     }
 
+    bool RequestHandler::AddProcedure(Procedure* procedure)
+    {
+        //cached results of a replaced procedure must not be returned anymore
+        bool added = this->procedures.Add(procedure);
+        this->cache.Clear();
+        return added;
+    }
+
     bool RequestHandler::RemoveProcedure(const std::string& procedure)
     {
-        map<string, Procedure*>::iterator it = this->procedures.find(procedure);
-        if (it != this->procedures.end())
-        {
-            this->procedures.erase(it);
-            return true;
-        }
-        else
+        bool removed = this->procedures.Remove(procedure);
+        this->cache.Clear();
+        return removed;
+    }
+
+    void RequestHandler::SetProcedureLookup(pProcedureLookup_t lookup,
+            void* data)
+    {
+        //publishing the unchanged table waits until running lookups have finished, so the old data may be freed afterwards
+        ProcedureRegistry::Transaction transaction(this->procedures);
+        this->procedureLookup = NULL;
+        __sync_synchronize();
+        this->procedureLookupData = data;
+        __sync_synchronize();
+        this->procedureLookup = lookup;
+        transaction.Commit();
+    }
+
+    unsigned int RequestHandler::HashProcedureName(const std::string& name,
+            unsigned int seed)
+    {
+        unsigned int hash = 2166136261u ^ seed;
+        for (size_t i = 0; i < name.length(); i++)
         {
-            return false;
+            hash = (hash ^ (unsigned char) name[i]) * 16777619u;
         }
+        return hash;
     }
 
     const Authenticator& RequestHandler::GetAuthManager() const
@@ -145,6 +216,11 @@ namespace jsonrpc
     }
 
     const procedurelist_t& RequestHandler::GetProcedures() const
+    {
+        return this->procedures.GetProcedures();
+    }
+
+    ProcedureRegistry& RequestHandler::GetProcedureRegistry()
     {
         return this->procedures;
     }
@@ -156,73 +232,274 @@ namespace jsonrpc
 
     void RequestHandler::SetProcedures(const procedurelist_t& procedures)
     {
-        this->procedures = procedures;
+        this->procedures.Replace(procedures);
+        this->cache.Clear();
     }
 
     void RequestHandler::HandleRequest(const std::string& request,
             std::string& retValue)
+    {
+        this->HandleRequest(request.data(), request.length(), retValue);
+    }
+
+    void RequestHandler::HandleRequest(const char* request, size_t length,
+            std::string& retValue, ResponseStream* stream)
     {
         Json::Reader reader;
         Json::Value req;
-        Json::Value response, resp;
+
+        uint64_t start = LatencyHistogram::Now();
+        bool parsed;
+        {
+            TraceSpan span("parse");
+            parsed = reader.parse(request, request + length, req, false);
+        }
+        uint64_t parseTime = LatencyHistogram::Now() - start;
+        this->metrics.RecordPhase(PHASE_PARSE, parseTime);
+
+        this->Respond(parsed ? &req : NULL, retValue, stream, parseTime);
+    }
+
+    void RequestHandler::HandleParsedRequest(Json::Value* request,
+            std::string& retValue, ResponseStream* stream)
+    {
+        //the request has been parsed while it was received, so the parse time is meaningless.
+        this->Respond(request, retValue, stream, 0);
+    }
+
+    bool RequestHandler::HandleRequest(const Json::Value& req,
+            Json::Value& response, ResponseStream* stream)
+    {
+        Procedure* procedure;
+        bool streamed = this->Dispatch(req, response, stream, procedure, NULL);
+        if (procedure != NULL)
+        {
+            this->procedures.Release(procedure);
+        }
+        //both belong to the caller
+        this->NotifyObservers(ON_REQUEST, req);
+        this->NotifyObservers(ON_RESPONSE, response);
+        return streamed;
+    }
+
+    const CallMetrics& RequestHandler::GetMetrics() const
+    {
+        return this->metrics;
+    }
+
+    const CallMetrics* RequestHandler::GetMetrics(
+            const std::string& procedure) const
+    {
+        ProcedureRegistry::ReadSection section(this->procedures);
+        Procedure* proc = this->procedures.Find(procedure);
+        return proc != NULL ? &proc->GetMetrics() : NULL;
+    }
+
+    void RequestHandler::ResetMetrics()
+    {
+        this->metrics.Reset();
+        ProcedureRegistry::ReadSection section(this->procedures);
+        const procedurelist_t& procedures = this->procedures.GetProcedures();
+        for (procedurelist_t::const_iterator it = procedures.begin();
+                it != procedures.end(); it++)
+        {
+            it->second->GetMetrics().Reset();
+        }
+    }
+
+    void RequestHandler::SetResponseCacheSize(size_t capacity)
+    {
+        this->cache.SetCapacity(capacity);
+    }
+
+    ResponseCache& RequestHandler::GetResponseCache()
+    {
+        return this->cache;
+    }
+
+    void RequestHandler::Respond(Json::Value* request,
+            std::string& retValue, ResponseStream* stream, uint64_t parseTime)
+    {
+        Json::Value response;
         Json::FastWriter w;
-        int error;
+        Procedure* procedure = NULL;
+        string cachedResult;
+
+        if (request != NULL)
+        {
+            if (this->Dispatch(*request, response, stream, procedure,
+                    &cachedResult))
+            {
+                retValue.clear();
+                this->procedures.Release(procedure);
+                this->MoveToObservers(ON_REQUEST, *request);
+                this->MoveToObservers(ON_RESPONSE, response);
+                return;
+            }
+        }
+        else
+        {
+            this->metrics.RecordCall();
+            this->metrics.RecordError();
+            createErrorBlock(ERROR_JSON_PARSE_ERROR, Json::Value::null,
+                    response);
+        }
 
-        //cout << "Request was: " << request << endl;
+        uint64_t start = LatencyHistogram::Now();
+        {
+            TraceSpan span("serialize");
+            if (cachedResult.empty())
+            {
+                retValue = w.write(response);
+            }
+            else
+            {
+                //the cached result is spliced into the response, with the members in the order of FastWriter
+                retValue = "{\"" KEY_REQUEST_ID "\":";
+                RequestBuffer::Append(retValue, response[KEY_REQUEST_ID]);
+                retValue += ",\"" KEY_REQUEST_VERSION "\":\"" JSON_RPC_VERSION "\",\"" KEY_RESPONSE_RESULT "\":";
+                retValue += cachedResult;
+                retValue += "}\n";
+            }
+        }
+        uint64_t serializeTime = LatencyHistogram::Now() - start;
 
-        if (reader.parse(request, req, false))
+        this->metrics.RecordPhase(PHASE_SERIALIZE, serializeTime);
+        if (procedure != NULL)
         {
-            this->NotifyObservers(this->requestObservers, req);
-            //It could be a Batch Request
-            if (req.isArray())
+            if (parseTime > 0)
             {
-                for (unsigned int i = 0; i < req.size(); i++)
-                {
-                    error = this->ValidateRequest(req[i]);
-                    if (error == ERROR_NO)
-                    {
-                        this->ProcessRequest(req[i], resp);
-                        if (!resp.isNull())
-                        {
-                            response[i] = resp;
-                        }
-                    }
-                    else
-                    {
-                        createErrorBlock(error, req[i], resp);
-                        response[i] = resp;
-                    }
-                }
-                //It could be a simple Request
+                procedure->GetMetrics().RecordPhase(PHASE_PARSE, parseTime);
             }
-            else if (req.isObject())
+            procedure->GetMetrics().RecordPhase(PHASE_SERIALIZE, serializeTime);
+            this->procedures.Release(procedure);
+        }
+
+        if (request != NULL)
+        {
+            if (!cachedResult.empty() && this->HasObservers(ON_RESPONSE))
             {
-                //cout << "validating request " << endl;
-                error = this->ValidateRequest(req);
-                if (error == ERROR_NO)
+                //observers get the same response as the client, the cached result is only parsed for them
+                Json::Reader reader;
+                reader.parse(cachedResult, response[KEY_RESPONSE_RESULT], false);
+            }
+            this->MoveToObservers(ON_REQUEST, *request);
+            this->MoveToObservers(ON_RESPONSE, response);
+        }
+    }
+
+    bool RequestHandler::Dispatch(const Json::Value& req,
+            Json::Value& response, ResponseStream* stream,
+            Procedure*& procedure, std::string* cachedResult)
+    {
+        bool streamed = false;
+        procedure = NULL;
+
+        //It could be a Batch Request
+        if (req.isArray())
+        {
+            for (unsigned int i = 0; i < req.size(); i++)
+            {
+                Json::Value resp;
+                Procedure* element;
+                //The elements of a batch response can't be streamed
+                this->HandleCall(req[i], resp, NULL, element, NULL);
+                if (element != NULL)
                 {
-                    //cout << "processing request" << endl;
-                    this->ProcessRequest(req, response);
+                    this->procedures.Release(element);
                 }
-                else
+                if (!resp.isNull())
                 {
-                    createErrorBlock(error, req, response);
+                    response[i].swap(resp);
                 }
             }
+            //It could be a simple Request
+        }
+        else if (req.isObject())
+        {
+            streamed = this->HandleCall(req, response, stream, procedure,
+                    cachedResult);
+        }
+        return streamed;
+    }
+
+    bool RequestHandler::HandleCall(const Json::Value& request,
+            Json::Value& response, ResponseStream* stream,
+            Procedure*& procedure, std::string* cachedResult)
+    {
+        bool streamed = false;
+
+        uint64_t start = LatencyHistogram::Now();
+        int error;
+        {
+            TraceSpan span("validate");
+            error = this->ValidateRequest(request, procedure);
+        }
+        uint64_t validated = LatencyHistogram::Now();
+
+        this->metrics.RecordCall();
+        this->metrics.RecordPhase(PHASE_VALIDATE, validated - start);
+        if (procedure != NULL)
+        {
+            procedure->GetMetrics().RecordCall();
+            procedure->GetMetrics().RecordPhase(PHASE_VALIDATE,
+                    validated - start);
+        }
+
+        if (error == ERROR_NO)
+        {
+            string key;
+            bool cacheable = cachedResult != NULL
+                    && procedure->GetCacheTtl() > 0
+                    && procedure->GetProcedureType() == RPC_METHOD
+                    && procedure->GetStreamPointer() == NULL
+                    && this->authManager == NULL
+                    && this->cache.GetCapacity() > 0;
+            if (cacheable)
+            {
+                ResponseCache::GetKey(procedure->GetProcedureName(),
+                        request[KEY_REQUEST_PARAMETERS], key);
+                if (this->cache.Get(key, *cachedResult))
+                {
+                    response[KEY_REQUEST_VERSION] = JSON_RPC_VERSION;
+                    response[KEY_REQUEST_ID] = request[KEY_REQUEST_ID];
+                    return false;
+                }
+            }
+            {
+                TraceSpan span("execute");
+                streamed = this->ProcessRequest(request, procedure, response,
+                        stream);
+            }
+            if (cacheable)
+            {
+                Json::FastWriter writer;
+                string result = writer.write(response[KEY_RESPONSE_RESULT]);
+                //FastWriter terminates the document with a newline
+                result.resize(result.length() - 1);
+                this->cache.Put(key, result, procedure->GetCacheTtl());
+            }
+            uint64_t executeTime = LatencyHistogram::Now() - validated;
+            this->metrics.RecordPhase(PHASE_EXECUTE, executeTime);
+            procedure->GetMetrics().RecordPhase(PHASE_EXECUTE, executeTime);
         }
         else
         {
-            createErrorBlock(ERROR_JSON_PARSE_ERROR, Json::Value::null,
-                    response);
+            createErrorBlock(error, request, response);
+            this->metrics.RecordError();
+            if (procedure != NULL)
+            {
+                procedure->GetMetrics().RecordError();
+            }
         }
-        retValue = w.write(response);
-        this->NotifyObservers(this->requestObservers, req);
+        return streamed;
     }
 
-    int RequestHandler::ValidateRequest(const Json::Value& request)
+    int RequestHandler::ValidateRequest(const Json::Value& request,
+            Procedure*& proc)
     {
         int error = ERROR_NO;
-        Procedure* proc;
+        proc = NULL;
         if (!(request.isMember(KEY_REQUEST_METHODNAME)
                 && request.isMember(KEY_REQUEST_VERSION)
                 && request.isMember(KEY_REQUEST_PARAMETERS)))
@@ -231,19 +508,37 @@ namespace jsonrpc
         }
         else
         {
-            map<string, Procedure*>::iterator it = procedures.find(
-                    request[KEY_REQUEST_METHODNAME].asString());
+            const string name = request[KEY_REQUEST_METHODNAME].asString();
+            if (this->procedureLookup != NULL)
+            {
+                ProcedureRegistry::ReadSection section(this->procedures);
+                pProcedureLookup_t lookup = this->procedureLookup;
+                if (lookup != NULL)
+                {
+                    proc = (*lookup)(this->procedureLookupData, name);
+                }
+                //procedures which have been replaced or removed meanwhile are not returned
+                if (proc != NULL && !this->procedures.Acquire(proc))
+                {
+                    proc = NULL;
+                }
+            }
+            if (proc == NULL)
+            {
+                //procedures added later on are only found in the registry
+                proc = this->procedures.Acquire(name);
+            }
 
-            if (it != this->procedures.end())
+            if (proc != NULL)
             {
-                proc =
-                        this->procedures[request[KEY_REQUEST_METHODNAME].asString()];
                 error = proc->ValdiateParameters(
                         request[KEY_REQUEST_PARAMETERS]);
                 if (error == ERROR_NO)
                 {
                     if (proc->GetMethodPointer() == NULL
-                            && proc->GetNotificationPointer() == NULL)
+                            && proc->GetNotificationPointer() == NULL
+                            && proc->GetStreamPointer() == NULL
+                            && proc->GetHandler() == NULL)
                     {
                         error = ERROR_PROCEDURE_POINTER_IS_NULL;
                     }
@@ -274,39 +569,165 @@ namespace jsonrpc
         return error;
     }
 
-    void RequestHandler::ProcessRequest(const Json::Value& request,
-            Json::Value& response)
+    bool RequestHandler::ProcessRequest(const Json::Value& request,
+            Procedure* method, Json::Value& response, ResponseStream* stream)
     {
-        Procedure* method =
-                this->procedures[request[KEY_REQUEST_METHODNAME].asString()];
         Json::Value result;
+        bool streamed = false;
         if (method->GetProcedureType() == RPC_METHOD)
         {
-            (*method->GetMethodPointer())(request[KEY_REQUEST_PARAMETERS],
-                    result);
-            //cout << "got result" << endl;
             response[KEY_REQUEST_VERSION] = JSON_RPC_VERSION;
-            response[KEY_RESPONSE_RESULT] = result;
             response[KEY_REQUEST_ID] = request[KEY_REQUEST_ID];
+            //the authentication header is needed before a streamed result starts
             if (this->authManager != NULL)
             {
                 this->authManager->ProcessAuthentication(
                         request[KEY_AUTHENTICATION],
                         response[KEY_AUTHENTICATION]);
             }
+
+            if (method->GetStreamPointer() != NULL)
+            {
+                ResultStream resultStream(stream, response);
+                (*method->GetStreamPointer())(request[KEY_REQUEST_PARAMETERS],
+                        resultStream);
+                streamed = resultStream.Finish(result);
+            }
+            else if (method->GetHandler() != NULL)
+            {
+                method->GetHandler()->HandleMethodCall(*method,
+                        request[KEY_REQUEST_PARAMETERS], result);
+            }
+            else
+            {
+                (*method->GetMethodPointer())(request[KEY_REQUEST_PARAMETERS],
+                        result);
+            }
+            if (!streamed)
+            {
+                response[KEY_RESPONSE_RESULT].swap(result);
+            }
         }
         else
         {
-            (*method->GetNotificationPointer())(
-                    request[KEY_REQUEST_PARAMETERS]);
+            if (method->GetHandler() != NULL)
+            {
+                method->GetHandler()->HandleNotificationCall(*method,
+                        request[KEY_REQUEST_PARAMETERS]);
+            }
+            else
+            {
+                (*method->GetNotificationPointer())(
+                        request[KEY_REQUEST_PARAMETERS]);
+            }
             response = Json::Value::null;
         }
+        return streamed;
+    }
+
+    void RequestHandler::NotifyObservers(observer_t type,
+            const Json::Value& message)
+    {
+        if (this->HasObservers(type))
+        {
+            this->QueueObservation(type, new Json::Value(message));
+        }
+    }
+
+    void RequestHandler::MoveToObservers(observer_t type, Json::Value& message)
+    {
+        if (this->HasObservers(type))
+        {
+            Json::Value* moved = new Json::Value();
+            moved->swap(message);
+            this->QueueObservation(type, moved);
+        }
+    }
+
+    bool RequestHandler::HasObservers(observer_t type) const
+    {
+        return (type == ON_RESPONSE ?
+                this->numResponseObservers : this->numRequestObservers) > 0;
+    }
+
+    void RequestHandler::QueueObservation(observer_t type,
+            Json::Value* message)
+    {
+        observerevent_t event;
+        event.isResponse = type == ON_RESPONSE;
+        event.message = message;
+        while (!this->observerQueue.Push(event))
+        {
+            if (this->dropPolicy == DROP_OLDEST)
+            {
+                observerevent_t oldest;
+                if (this->observerQueue.Pop(oldest))
+                {
+                    delete oldest.message;
+                    __sync_fetch_and_add(&this->droppedObserverEvents, 1);
+                    __sync_fetch_and_add(&this->processedObserverEvents, 1);
+                }
+            }
+            else if (this->dropPolicy == BLOCK_WHEN_FULL && !this->stopObservers)
+            {
+                sched_yield();
+            }
+            else
+            {
+                delete event.message;
+                __sync_fetch_and_add(&this->droppedObserverEvents, 1);
+                return;
+            }
+        }
+        //the increment is a full barrier, so either the observer thread sees the new event before it waits, or we see that it waits
+        __sync_fetch_and_add(&this->queuedObserverEvents, 1);
+        if (this->observerWaiting)
+        {
+            pthread_mutex_lock(&this->observerWaitLock);
+            pthread_cond_signal(&this->observerEvents);
+            pthread_mutex_unlock(&this->observerWaitLock);
+        }
     }
 
-    void RequestHandler::NotifyObservers(
-            const std::vector<observerFunction>& observerGroup,
-            const Json::Value& request)
+    void* RequestHandler::DeliverObservations(void* data)
     {
+        RequestHandler* _this = (RequestHandler*) data;
+        observerevent_t event;
+        while (true)
+        {
+            pthread_mutex_lock(&_this->observerWaitLock);
+            _this->observerWaiting = 1;
+            __sync_synchronize();
+            while (_this->processedObserverEvents >= _this->queuedObserverEvents
+                    && !_this->stopObservers)
+            {
+                pthread_cond_wait(&_this->observerEvents,
+                        &_this->observerWaitLock);
+            }
+            _this->observerWaiting = 0;
+            pthread_mutex_unlock(&_this->observerWaitLock);
+
+            while (_this->observerQueue.Pop(event))
+            {
+                pthread_mutex_lock(&_this->observerLock);
+                const vector<observerFunction>& observers =
+                        event.isResponse ?
+                                _this->responseObservers :
+                                _this->requestObservers;
+                for (unsigned int i = 0; i < observers.size(); i++)
+                {
+                    (*observers[i])(_this->instanceName, *event.message);
+                }
+                pthread_mutex_unlock(&_this->observerLock);
+                delete event.message;
+                __sync_fetch_and_add(&_this->processedObserverEvents, 1);
+            }
+            if (_this->stopObservers)
+            {
+                break;
+            }
+        }
+        return NULL;
     }
 
 } /* namespace jsonrpc */
@@ -11,9 +11,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <pthread.h>
 
 #include "procedure.h"
+#include "procedureregistry.h"
+#include "responsecache.h"
+#include "observerqueue.h"
 #include "authenticator.h"
+#include "responsestream.h"
 
 #define KEY_REQUEST_METHODNAME "method"
 #define KEY_REQUEST_VERSION "jsonrpc"
@@ -25,6 +30,11 @@
 
 #define JSON_RPC_VERSION "2.0"
 
+/**
+ * Number of requests and responses which may wait for delivery to the observers.
+ */
+#define OBSERVER_QUEUE_SIZE 4096
+
 namespace jsonrpc
 {
     /**
@@ -39,8 +49,22 @@ namespace jsonrpc
     {
         ON_RESPONSE, ON_REQUEST, ON_REQUEST_RESPONSE
     } observer_t;
-    
-    typedef std::map<std::string, Procedure*> procedurelist_t;
+
+    /**
+     * What happens to new requests and responses if the observers can't keep up and the queue is full.
+     */
+    typedef enum
+    {
+        DROP_NEWEST, DROP_OLDEST, BLOCK_WHEN_FULL
+    } droppolicy_t;
+
+
+    /**
+     * Type declaration signature of a procedure lookup, e.g. a perfect hash generated by jsonrpcstub.
+     * @param data - the pointer passed to RequestHandler::SetProcedureLookup.
+     * @return the procedure with this name, or NULL if there is none.
+     */
+    typedef Procedure* (*pProcedureLookup_t)(void* data, const std::string& name);
 
     class RequestHandler
     {
@@ -49,23 +73,102 @@ namespace jsonrpc
             virtual ~RequestHandler();
 
             /**
+             * Observers are called asynchronously by a background thread, with the instance name and the
+             * request (or response), so they don't add latency to the calls. The thread is started with the first observer.
+             * Requests are queued once they have been answered, together with their response. Requests and responses
+             * which are handled as text are moved into the queue, only those of the in-process HandleRequest are copied.
+             * Responses of streamed results only contain the header, without the result.
              * @param fp - the passed function is called on every request that comes in.
              * @param t - sets the type of this observer.
              */
             void AddObserver(observerFunction fp, observer_t t);
             void RemoveObserver(observerFunction fp);
 
+            /**
+             * @param policy - DROP_NEWEST (default) discards new events while the queue is full, DROP_OLDEST discards
+             * the oldest queued event instead, BLOCK_WHEN_FULL makes the calling worker thread wait for free space.
+             */
+            void SetObserverDropPolicy(droppolicy_t policy);
+
+            /**
+             * @return the number of requests and responses which have not been delivered to the observers, because the queue was full.
+             */
+            uint64_t GetDroppedObserverEvents() const;
+
+            /**
+             * Waits until all queued requests and responses have been delivered to the observers.
+             */
+            void FlushObservers();
+
+            /**
+             * Procedures can be added and removed while requests are handled (even by a procedure itself), see ProcedureRegistry.
+             * A procedure with the same name is replaced, replaced and removed procedures are deleted once their running calls have finished.
+             */
             bool AddProcedure(Procedure* procedure);
             bool RemoveProcedure(const std::string& procedure);
 
+            /**
+             * Sets a lookup, which is asked before the procedurelist for incoming requests (e.g. a perfect hash of the
+             * procedures known at compile time). The procedurelist is searched if the lookup does not find a procedure,
+             * or it returns one which is not part of the procedurelist anymore, so procedures may still be added, replaced and removed.
+             * The lookup may only return procedures which have been added to this handler, and must keep a reference
+             * of them (see ProcedureRegistry::Acquire), so they are not deleted while it can return them.
+             * Waits until running lookups have finished, the previous data may be freed afterwards.
+             * @param lookup - NULL switches back to the procedurelist only.
+             */
+            void SetProcedureLookup(pProcedureLookup_t lookup, void* data);
+
+            /**
+             * FNV-1a hash of a procedure name, used by the lookups generated by jsonrpcstub.
+             * @param seed - the generator searches for a seed which maps all procedure names to different slots.
+             */
+            static unsigned int HashProcedureName(const std::string& name, unsigned int seed);
+
             const Authenticator& GetAuthManager() const;
             const std::string& GetInstanceName() const;
 
             const std::vector<observerFunction>& GetResponseObservers() const;
             const std::vector<observerFunction>& GetRequestObservers() const;
+            /**
+             * @return the current procedures, while procedures are added or removed concurrently they must only be used
+             * inside a ProcedureRegistry::ReadSection of GetProcedureRegistry().
+             */
             const procedurelist_t& GetProcedures() const;
+            ProcedureRegistry& GetProcedureRegistry();
+
+            /**
+             * Metrics of all requests handled by this instance: every call (including each element of a batch)
+             * and every error response (including parse errors) is counted. The parse and serialize phases are
+             * measured once per request, validate and execute once per call.
+             */
+            const CallMetrics& GetMetrics() const;
+
+            /**
+             * Metrics of a single procedure. Parse and serialize are only recorded for calls which are not part of a batch.
+             * @return NULL if there is no procedure with this name, the metrics are deleted with the procedure.
+             */
+            const CallMetrics* GetMetrics(const std::string& procedure) const;
+
+            /**
+             * Sets the metrics of this instance and of all its procedures back to zero.
+             */
+            void ResetMetrics();
+
+            /**
+             * Enables caching the results of methods with a cache ttl (see Procedure::SetCacheTtl).
+             * Only single requests, which are handled as text, are answered from the cache (no batches, no streamed results),
+             * and only without Authenticator. If there are response observers, the cached result is parsed again for them,
+             * so they get the same response as the client.
+             * @param capacity - maximum size of the cache in bytes, 0 (default) disables it.
+             */
+            void SetResponseCacheSize(size_t capacity);
+            ResponseCache& GetResponseCache();
 
             void SetAuthManager(Authenticator* authManager);
+
+            /**
+             * Replaces all procedures at once, procedures which are not part of the new list are deleted.
+             */
             void SetProcedures(const procedurelist_t& procedures);
 
             /**
@@ -75,26 +178,91 @@ namespace jsonrpc
              */
             void HandleRequest(const std::string& request, std::string& retValue);
 
+            /**
+             * Same as above, but parses the request directly out of the given memory without copying it first.
+             *  @param request - points to the (not necessarily null terminated) request.
+             *  @param length - length of the request in bytes.
+             *  @param retValue a reference to string object which will hold the response after this method;
+             *  @param stream - if not NULL, results of streaming methods are sent through this stream. retValue stays empty in this case.
+             */
+            void HandleRequest(const char* request, size_t length, std::string& retValue, ResponseStream* stream = NULL);
+
+            /**
+             * Same as above, but works on an already parsed request and does not serialize the response.
+             * Useful for connectors which never see the request as text (e.g. in-process connectors).
+             *  @param request - holds (hopefully) a valid JSON-Request Object or a batch array.
+             *  @param retValue - will hold the response Object (or array for batch requests) afterwards, null for notifications.
+             *  @param stream - if not NULL, results of streaming methods are sent through this stream.
+             *  @return true if the response has already been sent through stream, retValue is meaningless then.
+             */
+            bool HandleRequest(const Json::Value& request, Json::Value& retValue, ResponseStream* stream = NULL);
+
+            /**
+             * For connectors which parse the request themselves, e.g. while it is still being received.
+             *  @param request - the parsed request, or NULL if the request was not valid JSON (a parse error is returned then).
+             *  It may be moved to the observers, its content is undefined afterwards.
+             *  @param retValue a reference to string object which will hold the response after this method;
+             *  @param stream - if not NULL, results of streaming methods are sent through this stream. retValue stays empty in this case.
+             */
+            void HandleParsedRequest(Json::Value* request, std::string& retValue, ResponseStream* stream = NULL);
+
         private:
 
-            int ValidateRequest(const Json::Value &val);
+            /**
+             * @param procedure - will point to the requested procedure afterwards, with a reference which has to be released,
+             * or NULL if it does not exist.
+             */
+            int ValidateRequest(const Json::Value &val, Procedure*& procedure);
+
+            /**
+             * Handles a single request or a batch.
+             * @param procedure - will point to the called procedure afterwards (with a reference, see ValidateRequest), NULL for batches and invalid requests.
+             * @param cachedResult - if not NULL, a single request may be answered from the cache, see HandleCall.
+             * @return true if the response has been sent through stream.
+             */
+            bool Dispatch(const Json::Value& request, Json::Value& response,
+                    ResponseStream* stream, Procedure*& procedure, std::string* cachedResult);
+
+            /**
+             * Validates and processes a single call and records its metrics.
+             * @param cachedResult - if not NULL and the result has been cached, it holds the serialized result afterwards,
+             * and response only holds the id and version.
+             * @return true if the response has been sent through stream.
+             */
+            bool HandleCall(const Json::Value& request, Json::Value& response,
+                    ResponseStream* stream, Procedure*& procedure, std::string* cachedResult);
+
+            /**
+             * Serializes the response to request, and moves both to the observers afterwards.
+             * @param parseTime - how long it took to parse the request in nanoseconds, 0 if unknown.
+             */
+            void Respond(Json::Value* request, std::string& retValue,
+                    ResponseStream* stream, uint64_t parseTime);
 
             /**
              * @pre the request must be a valid request
              * @param request - the request Object compliant to Json-RPC 2.0
+             * @param method - the requested procedure.
              * @param retValue - a reference to an object which will hold the returnValue afterwards.
+             * @param stream - the stream for results of streaming methods, NULL if they have to be collected.
+             * @return true if the response has been sent through stream.
              *
              * after calling this method, the requested Method will be executed. It is important, that this method only gets called once per request.
              */
-            void ProcessRequest(const Json::Value &request,
-                    Json::Value &retValue);
+            bool ProcessRequest(const Json::Value &request, Procedure* method,
+                    Json::Value &retValue, ResponseStream* stream);
 
             /**
-             * This method is called on each request, to notify all Registered Observers.
+             * These methods are called on each request and response, they queue it for the observer thread.
+             * NotifyObservers queues a copy, MoveToObservers swaps the message out, it is null afterwards.
+             * Nothing is copied or moved if there is no observer of this type.
              */
-            void NotifyObservers(
-                    const std::vector<observerFunction>& observerGroup,
-                    const Json::Value& request);
+            void NotifyObservers(observer_t type, const Json::Value& message);
+            void MoveToObservers(observer_t type, Json::Value& message);
+            bool HasObservers(observer_t type) const;
+            void QueueObservation(observer_t type, Json::Value* message);
+
+            static void* DeliverObservations(void* data);
 
             /**
              * Each Request Handler has its instancename to identify for logging purposes.
@@ -108,15 +276,47 @@ namespace jsonrpc
             std::vector<observerFunction> responseObservers;
 
             /**
-             * This map holds all procedures. The string holds the name of each procedure.
+             * The observer lists are only read by the observer thread, and modified by Add/RemoveObserver under this lock.
+             * Observers must therefore not add or remove observers themselves.
+             * The worker threads just check the counters, whether anything has to be queued at all.
              */
-            procedurelist_t procedures;
+            pthread_mutex_t observerLock;
+            volatile int numRequestObservers;
+            volatile int numResponseObservers;
+
+            ObserverQueue observerQueue;
+            /**
+             * The observer thread sets observerWaiting before it waits for observerEvents,
+             * the worker threads only signal it (under observerWaitLock) if it is set.
+             */
+            pthread_mutex_t observerWaitLock;
+            pthread_cond_t observerEvents;
+            volatile int observerWaiting;
+            pthread_t observerThread;
+            bool observerThreadRunning;
+            volatile bool stopObservers;
+            droppolicy_t dropPolicy;
+            volatile uint64_t queuedObserverEvents;
+            volatile uint64_t processedObserverEvents;
+            volatile uint64_t droppedObserverEvents;
+
+            /**
+             * This registry holds all procedures. Requests hold a reference of their procedure,
+             * from its lookup until its metrics have been recorded.
+             */
+            mutable ProcedureRegistry procedures;
+
+            ResponseCache cache;
+
+            pProcedureLookup_t procedureLookup;
+            void* procedureLookupData;
 
             /**
              * this objects decides whether a request is allowed to be processed or not.
              */
             Authenticator* authManager;
 
+            CallMetrics metrics;
     };
 
 } /* namespace jsonrpc */
@@ -0,0 +1,188 @@
+/**
+ * @file requestparser.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Parses a request while it is still being received.
+ */
+
+#include "requestparser.h"
+#include <cstring>
+
+namespace jsonrpc
+{
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    RequestParser::RequestParser()
+            : state(PARSER_START), used(0), scanned(0), elementStart(0), depth(
+                    0), inString(false), escaped(false), batch(Json::arrayValue)
+    {
+    }
+
+    char* RequestParser::GetBuffer(size_t size)
+    {
+        //The text of already parsed batch elements is not needed anymore.
+        if (this->elementStart > 0)
+        {
+            memmove(&this->buffer[0], &this->buffer[this->elementStart],
+                    this->used - this->elementStart);
+            this->used -= this->elementStart;
+            this->scanned -= this->elementStart;
+            this->elementStart = 0;
+        }
+        if (this->buffer.size() < this->used + size)
+        {
+            this->buffer.resize(this->used + size);
+        }
+        return &this->buffer[this->used];
+    }
+
+    bool RequestParser::Commit(size_t length)
+    {
+        this->used += length;
+        return this->Scan();
+    }
+
+    bool RequestParser::Consume(const char* data, size_t length)
+    {
+        memcpy(this->GetBuffer(length), data, length);
+        return this->Commit(length);
+    }
+
+    bool RequestParser::Finish(Json::Value& request)
+    {
+        switch (this->state)
+        {
+            case PARSER_OBJECT:
+                return this->reader.parse(&this->buffer[0],
+                        &this->buffer[0] + this->used, request, false);
+            case PARSER_DONE:
+                request.swap(this->batch);
+                return true;
+            default:
+                //empty, truncated or malformed
+                return false;
+        }
+    }
+
+    bool RequestParser::Scan()
+    {
+        const char* data = this->used > 0 ? &this->buffer[0] : NULL;
+        while (this->scanned < this->used)
+        {
+            char c = data[this->scanned];
+            switch (this->state)
+            {
+                case PARSER_START:
+                    if (c == '[')
+                    {
+                        this->state = PARSER_BATCH;
+                        this->depth = 1;
+                        this->elementStart = this->scanned + 1;
+                    }
+                    else if (c == '{')
+                    {
+                        this->state = PARSER_OBJECT;
+                    }
+                    else if (!isWhitespace(c))
+                    {
+                        this->state = PARSER_FAILED;
+                    }
+                    break;
+
+                case PARSER_OBJECT:
+                    //an object is parsed as a whole, no need to look at it now.
+                    this->scanned = this->used;
+                    return true;
+
+                case PARSER_BATCH:
+                    if (this->inString)
+                    {
+                        if (this->escaped)
+                        {
+                            this->escaped = false;
+                        }
+                        else if (c == '\\')
+                        {
+                            this->escaped = true;
+                        }
+                        else if (c == '"')
+                        {
+                            this->inString = false;
+                        }
+                    }
+                    else if (c == '"')
+                    {
+                        this->inString = true;
+                    }
+                    else if (c == '{' || c == '[')
+                    {
+                        this->depth++;
+                    }
+                    else if (c == '}' || c == ']')
+                    {
+                        this->depth--;
+                        if (this->depth == 0)
+                        {
+                            this->state = PARSER_DONE;
+                            if (!this->ParseElement(this->scanned))
+                            {
+                                this->state = PARSER_FAILED;
+                            }
+                            else
+                            {
+                                this->elementStart = this->scanned + 1;
+                            }
+                        }
+                    }
+                    else if (c == ',' && this->depth == 1)
+                    {
+                        if (!this->ParseElement(this->scanned))
+                        {
+                            this->state = PARSER_FAILED;
+                        }
+                        this->elementStart = this->scanned + 1;
+                    }
+                    break;
+
+                case PARSER_DONE:
+                    if (!isWhitespace(c))
+                    {
+                        this->state = PARSER_FAILED;
+                    }
+                    break;
+
+                case PARSER_FAILED:
+                    return false;
+            }
+            this->scanned++;
+        }
+        return this->state != PARSER_FAILED;
+    }
+
+    bool RequestParser::ParseElement(size_t end)
+    {
+        const char* begin = &this->buffer[this->elementStart];
+        const char* last = &this->buffer[0] + end;
+        while (begin < last && isWhitespace(*begin))
+        {
+            begin++;
+        }
+        if (begin == last)
+        {
+            //"[]" is an empty batch, but "[1,]" or "[,1]" are malformed
+            return this->state == PARSER_DONE && this->batch.size() == 0;
+        }
+
+        Json::Value element;
+        if (!this->reader.parse(begin, last, element, false))
+        {
+            return false;
+        }
+        this->batch.append(Json::Value()).swap(element);
+        return true;
+    }
+
+} /* namespace jsonrpc */
@@ -0,0 +1,75 @@
+/**
+ * @file requestparser.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Parses a request while it is still being received.
+ */
+
+#ifndef REQUESTPARSER_H_
+#define REQUESTPARSER_H_
+
+#include <vector>
+#include <json/json.h>
+
+namespace jsonrpc
+{
+    /**
+     * This class is fed with the request piece by piece, as the connector receives it.
+     * Batch requests are split into their elements on the fly: each element is parsed as soon as its last byte
+     * has arrived, and its text is dropped afterwards. So parsing overlaps with receiving, and only the element which
+     * is currently incomplete is buffered. A single request object can't be split, it is parsed as a whole in Finish.
+     * Malformed batches and requests which are neither objects nor arrays are recognised as early as possible.
+     */
+    class RequestParser
+    {
+        public:
+            RequestParser();
+
+            /**
+             * @return a buffer, into which the connector can receive up to size bytes. Call Commit afterwards.
+             */
+            char* GetBuffer(size_t size);
+
+            /**
+             * Processes the bytes which have been received into the buffer returned by GetBuffer.
+             * @return false if the request is already known to be invalid, there is no need to receive the rest then.
+             */
+            bool Commit(size_t length);
+
+            /**
+             * Copies the data into the buffer and processes it.
+             * @return false if the request is already known to be invalid.
+             */
+            bool Consume(const char* data, size_t length);
+
+            /**
+             * Must be called after the last piece of the request has been committed.
+             * @param request - will hold the parsed request (or batch array) afterwards.
+             * @return false if the request is not valid JSON.
+             */
+            bool Finish(Json::Value& request);
+
+        private:
+            typedef enum
+            {
+                PARSER_START, PARSER_OBJECT, PARSER_BATCH, PARSER_DONE, PARSER_FAILED
+            } parserstate_t;
+
+            bool Scan();
+            bool ParseElement(size_t end);
+
+            parserstate_t state;
+            std::vector<char> buffer;
+            size_t used;
+            size_t scanned;
+            size_t elementStart;
+            int depth;
+            bool inString;
+            bool escaped;
+
+            Json::Reader reader;
+            Json::Value batch;
+    };
+
+} /* namespace jsonrpc */
+#endif /* REQUESTPARSER_H_ */
@@ -0,0 +1,167 @@
+/**
+ * @file responsecache.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Sharded LRU cache for serialized results of idempotent procedures.
+ */
+
+#include "responsecache.h"
+#include "requesthandler.h"
+#include "latencyhistogram.h"
+
+using namespace std;
+
+/**
+ * Estimated memory of an entry besides its key and result (map node, list node, bookkeeping).
+ */
+#define RESPONSE_CACHE_ENTRY_OVERHEAD 128
+
+namespace jsonrpc
+{
+    ResponseCache::ResponseCache(size_t capacity)
+            : capacity(capacity), hits(0), misses(0)
+    {
+        for (int i = 0; i < RESPONSE_CACHE_SHARDS; i++)
+        {
+            pthread_mutex_init(&this->shards[i].lock, NULL);
+            this->shards[i].size = 0;
+        }
+    }
+
+    ResponseCache::~ResponseCache()
+    {
+        for (int i = 0; i < RESPONSE_CACHE_SHARDS; i++)
+        {
+            pthread_mutex_destroy(&this->shards[i].lock);
+        }
+    }
+
+    void ResponseCache::SetCapacity(size_t capacity)
+    {
+        this->capacity = capacity;
+        for (int i = 0; i < RESPONSE_CACHE_SHARDS; i++)
+        {
+            cacheshard_t& shard = this->shards[i];
+            pthread_mutex_lock(&shard.lock);
+            this->Evict(shard, capacity / RESPONSE_CACHE_SHARDS);
+            pthread_mutex_unlock(&shard.lock);
+        }
+    }
+
+    size_t ResponseCache::GetCapacity() const
+    {
+        return this->capacity;
+    }
+
+    void ResponseCache::GetKey(const std::string& procedure,
+            const Json::Value& params, std::string& key)
+    {
+        Json::FastWriter writer;
+        key = procedure;
+        key += '\n';
+        key += writer.write(params);
+    }
+
+    bool ResponseCache::Get(const std::string& key, std::string& result)
+    {
+        cacheshard_t& shard = this->shards[RequestHandler::HashProcedureName(key,
+                0) % RESPONSE_CACHE_SHARDS];
+        bool found = false;
+
+        pthread_mutex_lock(&shard.lock);
+        cacheentries_t::iterator it = shard.entries.find(key);
+        if (it != shard.entries.end())
+        {
+            if (it->second.expires > LatencyHistogram::Now())
+            {
+                shard.lru.splice(shard.lru.begin(), shard.lru,
+                        it->second.position);
+                result = it->second.result;
+                found = true;
+            }
+            else
+            {
+                this->Erase(shard, it);
+            }
+        }
+        pthread_mutex_unlock(&shard.lock);
+
+        __sync_fetch_and_add(found ? &this->hits : &this->misses, 1);
+        return found;
+    }
+
+    void ResponseCache::Put(const std::string& key, const std::string& result,
+            unsigned int ttl)
+    {
+        size_t capacity = this->capacity / RESPONSE_CACHE_SHARDS;
+        if (GetSize(key, result) > capacity)
+        {
+            return;
+        }
+        cacheshard_t& shard = this->shards[RequestHandler::HashProcedureName(key,
+                0) % RESPONSE_CACHE_SHARDS];
+        uint64_t expires = LatencyHistogram::Now() + ttl * (uint64_t) 1000000;
+
+        pthread_mutex_lock(&shard.lock);
+        cacheentries_t::iterator it = shard.entries.find(key);
+        if (it != shard.entries.end())
+        {
+            this->Erase(shard, it);
+        }
+        this->Evict(shard, capacity - GetSize(key, result));
+
+        it = shard.entries.insert(make_pair(key, cacheentry_t())).first;
+        it->second.result = result;
+        it->second.expires = expires;
+        shard.lru.push_front(&it->first);
+        it->second.position = shard.lru.begin();
+        shard.size += GetSize(key, result);
+        pthread_mutex_unlock(&shard.lock);
+    }
+
+    void ResponseCache::Clear()
+    {
+        for (int i = 0; i < RESPONSE_CACHE_SHARDS; i++)
+        {
+            cacheshard_t& shard = this->shards[i];
+            pthread_mutex_lock(&shard.lock);
+            shard.entries.clear();
+            shard.lru.clear();
+            shard.size = 0;
+            pthread_mutex_unlock(&shard.lock);
+        }
+    }
+
+    uint64_t ResponseCache::GetHits() const
+    {
+        return this->hits;
+    }
+
+    uint64_t ResponseCache::GetMisses() const
+    {
+        return this->misses;
+    }
+
+    void ResponseCache::Evict(cacheshard_t& shard, size_t capacity)
+    {
+        while (shard.size > capacity)
+        {
+            this->Erase(shard, shard.entries.find(*shard.lru.back()));
+        }
+    }
+
+    void ResponseCache::Erase(cacheshard_t& shard,
+            cacheentries_t::iterator entry)
+    {
+        shard.size -= GetSize(entry->first, entry->second.result);
+        shard.lru.erase(entry->second.position);
+        shard.entries.erase(entry);
+    }
+
+    size_t ResponseCache::GetSize(const std::string& key,
+            const std::string& result)
+    {
+        return key.length() + result.length() + RESPONSE_CACHE_ENTRY_OVERHEAD;
+    }
+
+} /* namespace jsonrpc */
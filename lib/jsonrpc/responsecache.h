@@ -0,0 +1,112 @@
+/**
+ * @file responsecache.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Sharded LRU cache for serialized results of idempotent procedures.
+ */
+
+#ifndef RESPONSECACHE_H_
+#define RESPONSECACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <stdint.h>
+#include <pthread.h>
+#include <json/json.h>
+
+/**
+ * Number of independently locked parts of the cache, each holds an equal share of its capacity.
+ */
+#define RESPONSE_CACHE_SHARDS 16
+
+namespace jsonrpc
+{
+    /**
+     * Maps a procedure name and its params to the serialized result of the call. Results expire after their
+     * time to live, and the least recently used results are evicted if a shard exceeds its share of the capacity.
+     * Keys are spread over RESPONSE_CACHE_SHARDS shards with their own locks, so worker threads rarely wait for each other.
+     */
+    class ResponseCache
+    {
+        public:
+            /**
+             * @param capacity - maximum size of all keys and results in bytes, 0 disables the cache.
+             */
+            ResponseCache(size_t capacity = 0);
+            ~ResponseCache();
+
+            /**
+             * Results are evicted until the new capacity is met.
+             */
+            void SetCapacity(size_t capacity);
+            size_t GetCapacity() const;
+
+            /**
+             * Builds the key of a call. Members of json objects are always written in the same (sorted) order,
+             * so equal params lead to equal keys.
+             */
+            static void GetKey(const std::string& procedure, const Json::Value& params, std::string& key);
+
+            /**
+             * @param result - holds the serialized result afterwards, if it has been found.
+             * @return false if there is no result for this key, or it has expired.
+             */
+            bool Get(const std::string& key, std::string& result);
+
+            /**
+             * @param result - the serialized result.
+             * @param ttl - time to live in milliseconds.
+             */
+            void Put(const std::string& key, const std::string& result, unsigned int ttl);
+
+            /**
+             * Drops all results, e.g. after the procedures have been changed.
+             */
+            void Clear();
+
+            uint64_t GetHits() const;
+            uint64_t GetMisses() const;
+
+        private:
+            typedef std::list<const std::string*> lrulist_t;
+
+            typedef struct
+            {
+                    std::string result;
+                    uint64_t expires;
+                    /**
+                     * Position in the lru list of the shard, which points back to the key of the entry.
+                     */
+                    lrulist_t::iterator position;
+            } cacheentry_t;
+
+            typedef std::map<std::string, cacheentry_t> cacheentries_t;
+
+            typedef struct
+            {
+                    pthread_mutex_t lock;
+                    cacheentries_t entries;
+                    /**
+                     * Most recently used entries first.
+                     */
+                    lrulist_t lru;
+                    size_t size;
+            } cacheshard_t;
+
+            /**
+             * @pre the lock of the shard is held.
+             */
+            void Evict(cacheshard_t& shard, size_t capacity);
+            void Erase(cacheshard_t& shard, cacheentries_t::iterator entry);
+
+            static size_t GetSize(const std::string& key, const std::string& result);
+
+            cacheshard_t shards[RESPONSE_CACHE_SHARDS];
+            volatile size_t capacity;
+            volatile uint64_t hits;
+            volatile uint64_t misses;
+    };
+
+} /* namespace jsonrpc */
+#endif /* RESPONSECACHE_H_ */
@@ -0,0 +1,42 @@
+/**
+ * @file responsestream.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Interface for connectors, which are able to send a response piece by piece.
+ */
+
+#ifndef RESPONSESTREAM_H_
+#define RESPONSESTREAM_H_
+
+#include <cstddef>
+
+namespace jsonrpc
+{
+
+    class ResponseStream
+    {
+        public:
+            virtual ~ResponseStream() {}
+
+            /**
+             * This method is called once before the first piece of the response is written.
+             * Connectors should send their headers (e.g. for chunked transfer encoding) here.
+             * @return true on success, false otherwise
+             */
+            virtual bool Begin() = 0;
+
+            /**
+             * This method should send the next piece of the response to the client.
+             * @return true on success, false otherwise
+             */
+            virtual bool Write(const char* data, size_t length) = 0;
+
+            /**
+             * This method is called after the last piece of the response has been written.
+             * @return true on success, false otherwise
+             */
+            virtual bool End() = 0;
+    };
+
+} /* namespace jsonrpc */
+#endif /* RESPONSESTREAM_H_ */
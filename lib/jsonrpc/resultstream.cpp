@@ -0,0 +1,92 @@
+/**
+ * @file resultstream.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Result of a streaming method, which is produced element by element.
+ */
+
+#include "resultstream.h"
+#include "requesthandler.h"
+
+namespace jsonrpc
+{
+
+    ResultStream::ResultStream(ResponseStream* output,
+            const Json::Value& header)
+            : output(output), header(header), collected(Json::arrayValue), started(
+                    false), failed(false)
+    {
+    }
+
+    bool ResultStream::Append(const Json::Value& element)
+    {
+        if (this->failed)
+        {
+            return false;
+        }
+        if (this->output == NULL)
+        {
+            this->collected.append(element);
+            return true;
+        }
+
+        if (!this->started)
+        {
+            //the header is serialized as object, its closing bracket is replaced by the opening of the result
+            this->buffer = this->writer.write(this->header);
+            this->buffer.erase(this->buffer.rfind('}'));
+            if (this->header.size() > 0)
+            {
+                this->buffer += ",";
+            }
+            this->buffer += "\"" KEY_RESPONSE_RESULT "\":[";
+            this->started = true;
+            if (!this->output->Begin())
+            {
+                this->failed = true;
+                return false;
+            }
+        }
+        else
+        {
+            this->buffer += ",";
+        }
+
+        this->buffer += this->writer.write(element);
+        //FastWriter terminates every document with a newline
+        this->buffer.erase(this->buffer.length() - 1);
+
+        if (this->buffer.length() >= RESULTSTREAM_FLUSH_SIZE)
+        {
+            return this->Flush();
+        }
+        return true;
+    }
+
+    bool ResultStream::Finish(Json::Value& result)
+    {
+        if (!this->started)
+        {
+            result.swap(this->collected);
+            return false;
+        }
+
+        this->buffer += "]}\n";
+        this->Flush();
+        this->output->End();
+        return true;
+    }
+
+    bool ResultStream::Flush()
+    {
+        if (!this->failed
+                && !this->output->Write(this->buffer.data(),
+                        this->buffer.length()))
+        {
+            this->failed = true;
+        }
+        this->buffer.clear();
+        return !this->failed;
+    }
+
+} /* namespace jsonrpc */
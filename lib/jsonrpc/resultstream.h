@@ -0,0 +1,63 @@
+/**
+ * @file resultstream.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Result of a streaming method, which is produced element by element.
+ */
+
+#ifndef RESULTSTREAM_H_
+#define RESULTSTREAM_H_
+
+#include <string>
+#include <json/json.h>
+
+#include "responsestream.h"
+
+/**
+ * Elements are collected up to this size (in bytes), before they are handed to the connector.
+ */
+#define RESULTSTREAM_FLUSH_SIZE (16 * 1024)
+
+namespace jsonrpc
+{
+    /**
+     * A streaming method gets an object of this class instead of a result Json::Value. The result of the method is
+     * always an array, whose elements are appended one after the other. If the connector supports streaming,
+     * the elements are serialized and sent right away, so the whole result never has to be kept in memory.
+     * Otherwise (or inside batch requests), the elements are collected and sent as an ordinary response.
+     */
+    class ResultStream
+    {
+        public:
+            /**
+             * @param output - the stream of the connector, or NULL if the result has to be collected.
+             * @param header - the response object without result (id, version, ...), it is sent in front of the first element.
+             */
+            ResultStream(ResponseStream* output, const Json::Value& header);
+
+            /**
+             * Appends the next element to the result array.
+             * @return false if the connection to the client broke, the method should stop producing elements then.
+             */
+            bool Append(const Json::Value& element);
+
+            /**
+             * Completes the result. If nothing has been sent yet, result will hold the collected elements afterwards.
+             * @return true if the response has been sent completely through the connector's stream.
+             */
+            bool Finish(Json::Value& result);
+
+        private:
+            bool Flush();
+
+            ResponseStream* output;
+            const Json::Value& header;
+            Json::Value collected;
+            Json::FastWriter writer;
+            std::string buffer;
+            bool started;
+            bool failed;
+    };
+
+} /* namespace jsonrpc */
+#endif /* RESULTSTREAM_H_ */
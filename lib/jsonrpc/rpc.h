@@ -12,12 +12,21 @@
 
 #include "server.h"
 #include "client.h"
+#include "requestparser.h"
+#include "tracer.h"
 
 //For error handling and catching Exceptions.
 #include "exception.h"
 
 #include "connectors/httpserver.h"
 #include "connectors/httpclient.h"
+#include "connectors/httpresponsestream.h"
+#include "connectors/sharedmemoryserver.h"
+#include "connectors/sharedmemoryclient.h"
+#include "connectors/loopbackserver.h"
+#include "connectors/loopbackclient.h"
+#include "connectors/websocketserver.h"
+#include "connectors/websocketclient.h"
 
 
 
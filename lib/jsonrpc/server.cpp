@@ -16,63 +16,60 @@ namespace jsonrpc
     Server::Server(const std::string& name, const std::string& configfile,
             methods_t& methods, notifications_t& notifications,
             ServerConnector* connector, Authenticator* auth)
+            : methods(methods), notifications(notifications)
     {
-        this->handler = new RequestHandler(name);
-        this->configFile = configfile;
-        this->auth = auth;
-        Procedure* proc;
-        Json::Reader reader;
-        Json::Value val, line;
-        string value;
+        this->Init(name, configfile, connector, auth);
+    }
 
-        ifstream config(configFile.c_str());
+    Server::Server(const std::string& name, const std::string& configfile,
+            ServerConnector* connector, Authenticator* auth)
+    {
+        this->Init(name, configfile, connector, auth);
+    }
 
-        if (config)
-        {
-            config.open(configfile.c_str(), ios::in);
-            value.assign((std::istreambuf_iterator<char>(config)),
-                    (std::istreambuf_iterator<char>()));
-        }
-        else
-        {
-            throw Exception(ERROR_CONFIGURATIONFILE_NOT_FOUND, configFile);
-        }
+    Server::Server(const std::string& name, ServerConnector* connector,
+            Authenticator* auth)
+    {
+        this->handler = new RequestHandler(name);
+        this->auth = auth;
+        this->connection = connector;
+        this->connection->SetHandler(this->handler);
+        this->watcher = NULL;
+    }
 
-        if (!reader.parse(value, val))
-        {
-            throw Exception(ERROR_PARSING_JSON);
-        }
+    void Server::Init(const std::string& name, const std::string& configfile,
+            ServerConnector* connector, Authenticator* auth)
+    {
+        this->handler = new RequestHandler(name);
+        this->configFile = configfile;
+        this->auth = auth;
 
-        notifications_t::iterator it_notifications;
-        methods_t::iterator it_methods;
-        for (unsigned int i = 0; i < val.size(); i++)
+        //procedures are bound before they are published, they must not be changed afterwards
+        vector<Procedure*> procedures = ParseProcedures(configfile);
+        for (unsigned int i = 0; i < procedures.size(); i++)
         {
-            line = val[i];
-            proc = new Procedure(line);
-            if (proc->GetProcedureType() == RPC_METHOD)
+            const string& name = procedures[i]->GetProcedureName();
+            if (procedures[i]->GetProcedureType() == RPC_METHOD
+                    && this->methods.count(name) > 0)
             {
-                it_methods = methods.find(proc->GetProcedureName());
-                if (it_methods != methods.end())
-                {
-                    proc->SetMethodPointer(it_methods->second);
-                }
+                procedures[i]->SetMethodPointer(this->methods[name]);
             }
-            else
+            if (procedures[i]->GetProcedureType() == RPC_NOTIFICATION
+                    && this->notifications.count(name) > 0)
             {
-                it_notifications = notifications.find(proc->GetProcedureName());
-                if (it_notifications != notifications.end())
-                {
-                    proc->SetNotificationPointer(it_notifications->second);
-                }
+                procedures[i]->SetNotificationPointer(this->notifications[name]);
             }
-            this->handler->AddProcedure(proc);
+            this->handler->AddProcedure(procedures[i]);
+            this->configuredProcedures.insert(procedures[i]->GetProcedureName());
         }
         this->connection = connector;
         this->connection->SetHandler(this->handler);
+        this->watcher = NULL;
     }
 
     Server::~Server()
     {
+        this->StopWatching();
         delete this->handler;
         this->StopListening();
         delete this->connection;
@@ -80,6 +77,10 @@ namespace jsonrpc
         {
             delete this->auth;
         }
+        for (unsigned int i = 0; i < this->procedureHandlers.size(); i++)
+        {
+            delete this->procedureHandlers[i];
+        }
     }
     
     bool Server::StartListening()
@@ -92,6 +93,246 @@ namespace jsonrpc
         return this->connection->StopListening();
     }
 
+    bool Server::AddStreamMethod(const std::string& name,
+            pStreamRequest_t method)
+    {
+        ProcedureRegistry::Transaction transaction(
+                this->handler->GetProcedureRegistry());
+        procedurelist_t& procedures = transaction.GetProcedures();
+        procedurelist_t::iterator it = procedures.find(name);
+        if (it == procedures.end()
+                || it->second->GetProcedureType() != RPC_METHOD)
+        {
+            return false;
+        }
+        Procedure* proc = new Procedure(*it->second);
+        proc->SetStreamPointer(method);
+        it->second = proc;
+        this->Publish(transaction);
+        return true;
+    }
+
+    bool Server::BindProcedure(const std::string& name,
+            ProcedureHandler* handler, int id, pValidator_t validator)
+    {
+        ProcedureRegistry::Transaction transaction(
+                this->handler->GetProcedureRegistry());
+        if (!Bind(transaction, name, NULL, handler, id, validator))
+        {
+            return false;
+        }
+        this->Publish(transaction);
+        return true;
+    }
+
+    bool Server::BindProcedure(const Procedure& declaration,
+            ProcedureHandler* handler, int id, pValidator_t validator)
+    {
+        ProcedureRegistry::Transaction transaction(
+                this->handler->GetProcedureRegistry());
+        if (!Bind(transaction, declaration.GetProcedureName(), &declaration,
+                handler, id, validator))
+        {
+            return false;
+        }
+        this->Publish(transaction);
+        return true;
+    }
+
+    bool Server::AddProcedure(Procedure* procedure, ProcedureHandler* handler)
+    {
+        ProcedureRegistry::Transaction transaction(
+                this->handler->GetProcedureRegistry());
+        procedurelist_t& procedures = transaction.GetProcedures();
+        if (procedures.count(procedure->GetProcedureName()) > 0
+                || !handler->Handles(procedure->GetProcedureType()))
+        {
+            delete procedure;
+            delete handler;
+            return false;
+        }
+        this->procedureHandlers.push_back(handler);
+        procedure->SetHandler(handler, 0);
+        procedures[procedure->GetProcedureName()] = procedure;
+        this->Publish(transaction);
+        return true;
+    }
+
+    bool Server::BindHandler(const std::string& name, ProcedureHandler* handler)
+    {
+        ProcedureRegistry::Transaction transaction(
+                this->handler->GetProcedureRegistry());
+        //the lock of the transaction protects procedureHandlers as well
+        this->procedureHandlers.push_back(handler);
+        if (!Bind(transaction, name, NULL, handler, 0, NULL))
+        {
+            return false;
+        }
+        this->Publish(transaction);
+        return true;
+    }
+
+    /**
+     * @return true if both procedures are called the same way, so their arguments are found at the same positions.
+     */
+    static bool equalParameters(const Procedure& a, const Procedure& b)
+    {
+        return a.GetProcedureType() == b.GetProcedureType()
+                && a.GetParameterDeclaration() == b.GetParameterDeclaration()
+                && a.GetOrderedParameters() == b.GetOrderedParameters();
+    }
+
+    bool Server::Bind(ProcedureRegistry::Transaction& transaction,
+            const std::string& name, const Procedure* declaration,
+            ProcedureHandler* handler, int id, pValidator_t validator)
+    {
+        procedurelist_t& procedures = transaction.GetProcedures();
+        procedurelist_t::iterator it = procedures.find(name);
+        if (it == procedures.end()
+                || !handler->Handles(it->second->GetProcedureType())
+                || (declaration != NULL
+                        && !equalParameters(*it->second, *declaration)))
+        {
+            return false;
+        }
+        Procedure* proc = new Procedure(*it->second);
+        proc->SetHandler(handler, id);
+        if (validator != NULL)
+        {
+            proc->SetValidator(validator);
+        }
+        it->second = proc;
+        return true;
+    }
+
+    void Server::Publish(ProcedureRegistry::Transaction& transaction)
+    {
+        transaction.Commit();
+        //cached results of changed procedures must not be returned anymore
+        this->handler->GetResponseCache().Clear();
+    }
+
+    /**
+     * @return true if both procedures are declared the same way, so they can be used interchangeably.
+     */
+    static bool equalDeclarations(const Procedure& a, const Procedure& b)
+    {
+        return equalParameters(a, b)
+                && a.HasReturnType() == b.HasReturnType()
+                && (!a.HasReturnType() || a.GetReturnType() == b.GetReturnType());
+    }
+
+    bool Server::ReloadProcedures()
+    {
+        vector<Procedure*> parsed;
+        try
+        {
+            parsed = ParseProcedures(this->configFile);
+        }
+        catch (Exception& e)
+        {
+            return false;
+        }
+
+        //the merge is computed under the write lock of the registry, so procedures added or removed meanwhile are not lost
+        ProcedureRegistry::Transaction transaction(
+                this->handler->GetProcedureRegistry());
+        procedurelist_t& next = transaction.GetProcedures();
+        const procedurelist_t current = next;
+        for (set<string>::iterator it = this->configuredProcedures.begin();
+                it != this->configuredProcedures.end(); it++)
+        {
+            next.erase(*it);
+        }
+
+        set<string> configured;
+        for (unsigned int i = 0; i < parsed.size(); i++)
+        {
+            Procedure* proc = parsed[i];
+            const string& name = proc->GetProcedureName();
+            procedurelist_t::const_iterator it = current.find(name);
+            Procedure* old = it != current.end() ? it->second : NULL;
+
+            if (configured.count(name) > 0
+                    || (old != NULL && this->configuredProcedures.count(name) == 0))
+            {
+                //declared twice, or added with AddProcedure
+                delete proc;
+                continue;
+            }
+            configured.insert(name);
+
+            if (old != NULL
+                    && (equalDeclarations(*old, *proc) || old->GetHandler() != NULL))
+            {
+                if (old->GetCacheTtl() == proc->GetCacheTtl())
+                {
+                    next[name] = old;
+                    delete proc;
+                    continue;
+                }
+                //the old procedure may be called meanwhile, so it is replaced by a copy with the new ttl
+                Procedure* copy = new Procedure(*old);
+                copy->SetCacheTtl(proc->GetCacheTtl());
+                next[name] = copy;
+                delete proc;
+                continue;
+            }
+
+            if (old != NULL)
+            {
+                proc->SetMethodPointer(old->GetMethodPointer());
+                proc->SetNotificationPointer(old->GetNotificationPointer());
+                proc->SetStreamPointer(old->GetStreamPointer());
+            }
+            if (proc->GetProcedureType() == RPC_METHOD
+                    && proc->GetMethodPointer() == NULL
+                    && this->methods.count(name) > 0)
+            {
+                proc->SetMethodPointer(this->methods[name]);
+            }
+            if (proc->GetProcedureType() == RPC_NOTIFICATION
+                    && proc->GetNotificationPointer() == NULL
+                    && this->notifications.count(name) > 0)
+            {
+                proc->SetNotificationPointer(this->notifications[name]);
+            }
+            next[name] = proc;
+        }
+
+        this->configuredProcedures = configured;
+        this->Publish(transaction);
+        return true;
+    }
+
+    bool Server::StartWatching()
+    {
+        if (this->configFile.empty())
+        {
+            return false;
+        }
+        if (this->watcher == NULL)
+        {
+            this->watcher = new FileWatcher(this->configFile,
+                    &Server::OnConfigFileChanged, this);
+        }
+        return this->watcher->Start();
+    }
+
+    void Server::StopWatching()
+    {
+        if (this->watcher != NULL)
+        {
+            delete this->watcher;
+            this->watcher = NULL;
+        }
+    }
+
+    void Server::OnConfigFileChanged(void* server)
+    {
+        ((Server*) server)->ReloadProcedures();
+    }
+
     std::vector<Procedure*> Server::ParseProcedures(const std::string& configfile)
     {
         Procedure* proc;
@@ -104,7 +345,6 @@ namespace jsonrpc
 
         if (config)
         {
-            config.open(configfile.c_str(), ios::in);
             value.assign((std::istreambuf_iterator<char>(config)),
                     (std::istreambuf_iterator<char>()));
         }
@@ -9,11 +9,15 @@
 #define SERVER_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "requesthandler.h"
 #include "serverconnector.h"
+#include "procedurehandler.h"
+#include "callbackhandler.h"
+#include "filewatcher.h"
 
 namespace jsonrpc
 {
@@ -24,24 +28,135 @@ namespace jsonrpc
     {
         public:
             Server(const std::string& name, const std::string& configfile, methods_t& methods, notifications_t& notifications, ServerConnector* connector, Authenticator* auth = NULL);
+
+            /**
+             * Creates a server whose procedures are not bound to any functions yet, they have to be bound with
+             * BindProcedure or AddStreamMethod (e.g. by a server stub generated by jsonrpcstub).
+             */
+            Server(const std::string& name, const std::string& configfile, ServerConnector* connector, Authenticator* auth = NULL);
+
+            /**
+             * Creates a server without any procedures, they have to be added with AddProcedure or to its handler (e.g. by a server stub generated by jsonrpcstub).
+             */
+            Server(const std::string& name, ServerConnector* connector, Authenticator* auth = NULL);
             virtual ~Server();
 
             bool StartListening();
             bool StopListening();
 
+            /**
+             * Registers a streaming function for a method of the configuration file. It is called instead of the
+             * method pointer, its result array is sent piece by piece if the connector supports it.
+             * Like BindProcedure, it replaces the procedure with a bound copy, whose metrics start at zero.
+             * @return false if there is no method with this name.
+             */
+            bool AddStreamMethod(const std::string& name, pStreamRequest_t method);
+
+            /**
+             * Binds a procedure of the configuration file to a handler object, which is called instead of its method or notification pointer.
+             * The procedure is not changed while it may be called, it is replaced by a bound copy.
+             * @param id - is passed to the handler with each call, see Procedure::GetHandlerId.
+             * @param validator - if not NULL, it replaces the validation against the configuration file, see Procedure::SetValidator.
+             * @return false if there is no procedure with this name, or the handler can't handle its type (see ProcedureHandler::Handles).
+             */
+            bool BindProcedure(const std::string& name, ProcedureHandler* handler, int id, pValidator_t validator = NULL);
+
+            /**
+             * Same as above, for handlers which have been compiled for a certain declaration of the procedure
+             * (e.g. generated stubs, which expect their arguments at fixed positions, see ProcedureHandler::GetArguments).
+             * @param declaration - the procedure with this name is only bound, if it has the same type and the same parameters (in the same order).
+             * @return false as above, or if the configuration file declares the procedure differently.
+             */
+            bool BindProcedure(const Procedure& declaration, ProcedureHandler* handler, int id, pValidator_t validator = NULL);
+
+            /**
+             * Adds a procedure without configuration file, its calls are handed to handler
+             * (e.g. created by MakeMethodHandler for a member function or a callable object).
+             * The server takes ownership of the procedure and of the handler.
+             * @return false if there is already a procedure with this name, or the handler can't handle its type
+             * (e.g. a notification handler for a method). Procedure and handler are deleted then.
+             */
+            bool AddProcedure(Procedure* procedure, ProcedureHandler* handler);
+
+            /**
+             * Same as BindProcedure, but the server takes ownership of the handler (it is deleted even if it can't be bound).
+             */
+            bool BindHandler(const std::string& name, ProcedureHandler* handler);
+
+            /**
+             * Parses the configuration file again and swaps in its procedures atomically, while requests keep being handled.
+             * Procedures whose declaration did not change are kept as they are (including their bindings and metrics),
+             * only their cache ttl is taken from the file (a procedure whose ttl changed is replaced by a copy with new metrics).
+             * Changed procedures keep the functions they were bound to, new ones are bound to the functions passed to the constructor.
+             * Procedures bound to a ProcedureHandler (e.g. of a generated stub) can't follow a changed declaration,
+             * they keep their old one. Procedures removed from the file are removed, procedures added with AddProcedure are kept.
+             * The merge is done under the write lock of the ProcedureRegistry, so concurrent changes are not lost.
+             * @return false if the file can't be read or parsed, nothing is changed then.
+             */
+            bool ReloadProcedures();
+
+            /**
+             * Starts a thread which calls ReloadProcedures whenever the configuration file has been rewritten (inotify).
+             * @return false if there is no configuration file, or it can't be watched (e.g. on platforms without inotify).
+             */
+            bool StartWatching();
+            void StopWatching();
+
             const std::string& GetConfigFile() const
             {
                 return configFile;
             }
 
+            /**
+             * @return the RequestHandler of this server, e.g. to read its metrics.
+             */
+            RequestHandler& GetHandler()
+            {
+                return *handler;
+            }
+
             static std::vector<Procedure*> ParseProcedures(const std::string& configfile);
 
         private:
+            void Init(const std::string& name, const std::string& configfile, ServerConnector* connector, Authenticator* auth);
+
+            static void OnConfigFileChanged(void* server);
+
+            /**
+             * Replaces the procedure with a copy, which is bound to handler.
+             * @param declaration - if not NULL, the procedure has to be declared with the same type and parameters.
+             * @return false if there is no procedure with this name, the handler can't handle its type, or it is declared differently.
+             */
+            static bool Bind(ProcedureRegistry::Transaction& transaction, const std::string& name, const Procedure* declaration,
+                    ProcedureHandler* handler, int id, pValidator_t validator);
+
+            /**
+             * Commits a change of the procedures and drops the cached results.
+             */
+            void Publish(ProcedureRegistry::Transaction& transaction);
+
             Authenticator* auth;
             ServerConnector* connection;
             RequestHandler* handler;
             std::string configFile;
 
+            /**
+             * Handlers owned by this server, see AddProcedure and BindHandler.
+             */
+            std::vector<ProcedureHandler*> procedureHandlers;
+
+            /**
+             * Functions for procedures, which are added to the configuration file later on.
+             */
+            methods_t methods;
+            notifications_t notifications;
+
+            /**
+             * Names of the procedures which have been declared in the configuration file.
+             */
+            std::set<std::string> configuredProcedures;
+            FileWatcher* watcher;
+
     };
 
 } /* namespace jsonrpc */
@@ -6,6 +6,7 @@
  */
 
 #include "serverconnector.h"
+#include "tracer.h"
 #include <cstdlib>
 
 using namespace std;
@@ -22,13 +23,73 @@ namespace jsonrpc
     {
     }
     
+    ResponseStream* ServerConnector::CreateResponseStream(void* addInfo)
+    {
+        return NULL;
+    }
+
     bool ServerConnector::OnRequest(const std::string& request, void* addInfo)
+    {
+        return this->OnRequest(request.data(), request.length(), addInfo);
+    }
+
+    bool ServerConnector::OnRequest(const char* request, size_t length,
+            void* addInfo)
     {
         string response;
+        if (this->handler != NULL)
+        {
+            ResponseStream* stream = this->CreateResponseStream(addInfo);
+            {
+                TraceSpan span("handle");
+                this->handler->HandleRequest(request, length, response, stream);
+            }
+            delete stream;
+            //an empty response means, it has already been streamed
+            if (!response.empty())
+            {
+                TraceSpan span("send");
+                this->SendResponse(response, addInfo);
+            }
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    bool ServerConnector::OnParsedRequest(Json::Value* request,
+            void* addInfo)
+    {
+        string response;
+        if (this->handler != NULL)
+        {
+            ResponseStream* stream = this->CreateResponseStream(addInfo);
+            {
+                TraceSpan span("handle");
+                this->handler->HandleParsedRequest(request, response, stream);
+            }
+            delete stream;
+            if (!response.empty())
+            {
+                TraceSpan span("send");
+                this->SendResponse(response, addInfo);
+            }
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    bool ServerConnector::OnRequest(const Json::Value& request,
+            Json::Value& response)
+    {
         if (this->handler != NULL)
         {
             this->handler->HandleRequest(request, response);
-            this->SendResponse(response, addInfo);
             return true;
         }
         else
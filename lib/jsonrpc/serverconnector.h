@@ -39,6 +39,15 @@ namespace jsonrpc
             bool virtual SendResponse(const std::string& response,
                     void* addInfo = NULL) = 0;
 
+            /**
+             * Connectors which are able to send a response in pieces (e.g. by chunked transfer encoding) should override this method.
+             * It is called for each request, the returned stream is deleted after the request has been handled.
+             * Results of streaming methods are sent through this stream instead of SendResponse.
+             * @param addInfo - additional Info, that the Connector might need for responding.
+             * @return a new stream, or NULL (default) if the connector does not support streaming.
+             */
+            virtual ResponseStream* CreateResponseStream(void* addInfo);
+
             /**
              * This method must be called, when a request is recognised. It will do everything else for you (including sending the response).
              * @param request - the request that has been recognised.
@@ -46,11 +55,41 @@ namespace jsonrpc
              */
             bool OnRequest(const std::string& request, void* addInfo = NULL);
 
+            /**
+             * Same as above, for connectors which receive the request into their own buffers. The request is parsed
+             * directly out of this buffer, so it is not copied.
+             * @param request - points to the request, it doesn't need to be null terminated.
+             * @param length - length of the request in bytes.
+             * @param addInfo - additional Info, that the Connector might need for responding.
+             */
+            bool OnRequest(const char* request, size_t length, void* addInfo = NULL);
+
+            /**
+             * Same as above, for connectors which parse the request themselves (e.g. with a RequestParser while receiving it).
+             * @param request - the parsed request, or NULL if it was not valid JSON. It may be moved to the observers of the handler.
+             * @param addInfo - additional Info, that the Connector might need for responding.
+             */
+            bool OnParsedRequest(Json::Value* request, void* addInfo = NULL);
+
+            /**
+             * This method can be called by connectors, which receive requests already parsed and deliver the response
+             * object directly to the caller. SendResponse is not called in this case.
+             * @param request - the request that has been recognised.
+             * @param response - will hold the response afterwards (null for notifications).
+             * @return false if no handler has been set.
+             */
+            bool OnRequest(const Json::Value& request, Json::Value& response);
+
             void SetHandler(RequestHandler* handler)
             {
                 this->handler = handler;
             }
 
+            RequestHandler* GetHandler() const
+            {
+                return this->handler;
+            }
+
         private:
             RequestHandler* handler;
     };
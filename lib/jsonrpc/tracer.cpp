@@ -0,0 +1,198 @@
+/**
+ * @file tracer.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Low overhead tracing of the processing phases of requests.
+ */
+
+#include "tracer.h"
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <pthread.h>
+#include <time.h>
+
+using namespace std;
+
+namespace jsonrpc
+{
+    typedef struct
+    {
+            const char* name;
+            uint64_t begin;
+            uint64_t end;
+    } traceevent_t;
+
+    /**
+     * The ring buffer of a single thread. Only its thread writes to it, readers copy it while holding the registry lock.
+     * Buffers of finished threads stay registered until Clear, so their spans can still be written.
+     */
+    typedef struct
+    {
+            int thread;
+            bool finished;
+            volatile uint32_t count;
+            traceevent_t events[TRACE_BUFFER_SIZE];
+    } tracebuffer_t;
+
+    volatile bool Tracer::enabled = false;
+
+    static pthread_mutex_t registryLock = PTHREAD_MUTEX_INITIALIZER;
+    static vector<tracebuffer_t*> registry;
+    static int nextThread = 1;
+
+    static pthread_key_t bufferKey;
+    static pthread_once_t bufferKeyOnce = PTHREAD_ONCE_INIT;
+
+    //calibration, ticks per nanosecond and the tick count at the time of Enable
+    static double ticksPerNanosecond = 1.0;
+    static uint64_t startTicks = 0;
+
+    static void releaseBuffer(void* data)
+    {
+        pthread_mutex_lock(&registryLock);
+        ((tracebuffer_t*) data)->finished = true;
+        pthread_mutex_unlock(&registryLock);
+    }
+
+    static void createBufferKey()
+    {
+        pthread_key_create(&bufferKey, &releaseBuffer);
+    }
+
+    static tracebuffer_t* getBuffer()
+    {
+        pthread_once(&bufferKeyOnce, &createBufferKey);
+        tracebuffer_t* buffer = (tracebuffer_t*) pthread_getspecific(bufferKey);
+        if (buffer == NULL)
+        {
+            buffer = new tracebuffer_t;
+            buffer->finished = false;
+            buffer->count = 0;
+            pthread_mutex_lock(&registryLock);
+            buffer->thread = nextThread++;
+            registry.push_back(buffer);
+            pthread_mutex_unlock(&registryLock);
+            pthread_setspecific(bufferKey, buffer);
+        }
+        return buffer;
+    }
+
+    static uint64_t getClockTime()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    void Tracer::Enable()
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        uint64_t clockStart = getClockTime();
+        uint64_t ticks = Now();
+        struct timespec pause = { 0, 10000000 };
+        nanosleep(&pause, NULL);
+        ticksPerNanosecond = (double) (Now() - ticks)
+                / (getClockTime() - clockStart);
+#endif
+        startTicks = Now();
+        enabled = true;
+    }
+
+    void Tracer::Disable()
+    {
+        enabled = false;
+    }
+
+    uint64_t Tracer::Now()
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        uint32_t low, high;
+        __asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+        return ((uint64_t) high << 32) | low;
+#else
+        return getClockTime();
+#endif
+    }
+
+    uint64_t Tracer::FromNanoseconds(uint64_t nanoseconds)
+    {
+        return (uint64_t) (nanoseconds * ticksPerNanosecond);
+    }
+
+    void Tracer::Record(const char* name, uint64_t begin, uint64_t end)
+    {
+        tracebuffer_t* buffer = getBuffer();
+        traceevent_t& event = buffer->events[buffer->count % TRACE_BUFFER_SIZE];
+        event.name = name;
+        event.begin = begin;
+        event.end = end;
+        //the event must be complete, before a reader can see it
+        __sync_synchronize();
+        buffer->count++;
+    }
+
+    void Tracer::WriteChromeTrace(std::ostream& out)
+    {
+        char line[256];
+        bool first = true;
+
+        out << "{\"traceEvents\":[";
+        pthread_mutex_lock(&registryLock);
+        for (size_t i = 0; i < registry.size(); i++)
+        {
+            tracebuffer_t* buffer = registry[i];
+            uint32_t count = buffer->count;
+            uint32_t start = count > TRACE_BUFFER_SIZE ? count - TRACE_BUFFER_SIZE : 0;
+            for (uint32_t j = start; j < count; j++)
+            {
+                const traceevent_t& event = buffer->events[j % TRACE_BUFFER_SIZE];
+                if (event.begin < startTicks)
+                {
+                    continue;
+                }
+                snprintf(line, sizeof(line),
+                        "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        first ? "" : ",", event.name, buffer->thread,
+                        (event.begin - startTicks) / ticksPerNanosecond / 1000.0,
+                        (event.end - event.begin) / ticksPerNanosecond / 1000.0);
+                out << line;
+                first = false;
+            }
+        }
+        pthread_mutex_unlock(&registryLock);
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    bool Tracer::WriteChromeTrace(const std::string& filename)
+    {
+        ofstream file(filename.c_str());
+        if (!file)
+        {
+            return false;
+        }
+        WriteChromeTrace(file);
+        return file.good();
+    }
+
+    void Tracer::Clear()
+    {
+        pthread_mutex_lock(&registryLock);
+        for (size_t i = 0; i < registry.size();)
+        {
+            if (registry[i]->finished)
+            {
+                delete registry[i];
+                registry.erase(registry.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+        //buffers of running threads are not touched, their older spans are just skipped from now on.
+        startTicks = Now();
+        pthread_mutex_unlock(&registryLock);
+    }
+
+} /* namespace jsonrpc */
@@ -184,6 +184,7 @@ typedef struct DIR {
 #include <sys/socket.h>
 #include <sys/select.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <sys/time.h>
 #include <stdint.h>
@@ -239,6 +240,13 @@ typedef int SOCKET;
 #define MAX_REQUEST_SIZE 16384
 #define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
 
+// Statistics counters are updated by all worker threads without locking.
+#if defined(__GNUC__)
+#define ATOMIC_ADD(ptr, value) __sync_fetch_and_add((ptr), (value))
+#else
+#define ATOMIC_ADD(ptr, value) (*(ptr) += (value))
+#endif
+
 #ifdef _WIN32
 static CRITICAL_SECTION global_log_file_lock;
 static pthread_t pthread_self(void) {
@@ -440,6 +448,7 @@ struct socket {
   union usa lsa;        // Local socket address
   union usa rsa;        // Remote socket address
   int is_ssl;           // Is socket SSL-ed
+  long long accept_time; // Monotonic time of accept(), in nanoseconds
 };
 
 // NOTE(lsm): this enum shoulds be in sync with the config_options below.
@@ -500,6 +509,10 @@ struct mg_context {
   volatile int sq_tail;      // Tail of the socket queue
   pthread_cond_t sq_full;    // Signaled when socket is produced
   pthread_cond_t sq_empty;   // Signaled when socket is consumed
+
+  volatile int busy_threads;          // Workers serving a connection
+  volatile long long bytes_received;  // Total bytes read from sockets
+  volatile long long bytes_sent;      // Total bytes written by mg_write()
 };
 
 struct mg_connection {
@@ -660,6 +673,25 @@ static struct mg_connection *fc(struct mg_context *ctx) {
   return &fake_connection;
 }
 
+// Monotonic clock in nanoseconds, used to measure the accept queue wait.
+static long long get_monotonic_time(void) {
+#ifdef _WIN32
+  return 0;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+void mg_get_stats(const struct mg_context *ctx, struct mg_stats *stats) {
+  stats->queued_connections = ctx->sq_head - ctx->sq_tail;
+  stats->busy_threads = ctx->busy_threads;
+  stats->num_threads = atoi(ctx->config[NUM_THREADS]);
+  stats->bytes_received = ctx->bytes_received;
+  stats->bytes_sent = ctx->bytes_sent;
+}
+
 const char *mg_version(void) {
   return MONGOOSE_VERSION;
 }
@@ -1507,6 +1539,10 @@ static int pull(FILE *fp, struct mg_connection *conn, char *buf, int len) {
     nread = recv(conn->client.sock, buf, (size_t) len, 0);
   }
 
+  if (fp == NULL && nread > 0) {
+    ATOMIC_ADD(&conn->ctx->bytes_received, nread);
+  }
+
   return conn->ctx->stop_flag ? -1 : nread;
 }
 
@@ -1590,6 +1626,9 @@ int mg_write(struct mg_connection *conn, const void *buf, size_t len) {
     total = push(NULL, conn->client.sock, conn->ssl, (const char *) buf,
                  (int64_t) len);
   }
+  if (total > 0) {
+    ATOMIC_ADD(&conn->ctx->bytes_sent, total);
+  }
   return (int) total;
 }
 
@@ -3807,8 +3846,8 @@ static void read_websocket(struct mg_connection *conn) {
         mask = buf + 4;
       } else if (body_len >= 10) {
         conn->content_len = 10 + mask_len +
-          (((uint64_t) htonl(* (uint32_t *) &buf[2])) << 32) |
-          htonl(* (uint32_t *) &buf[6]);
+          ((((uint64_t) htonl(* (uint32_t *) &buf[2])) << 32) |
+           htonl(* (uint32_t *) &buf[6]));
         mask = buf + 10;
       }
     }
@@ -3819,7 +3858,7 @@ static void read_websocket(struct mg_connection *conn) {
       }
       discard_len = conn->content_len > body_len ?
           body_len : (int) conn->content_len;
-      memmove(buf, buf + discard_len, conn->data_len - discard_len);
+      memmove(buf, buf + discard_len, body_len - discard_len);
       conn->data_len -= discard_len;
       conn->content_len = conn->consumed_content = 0;
     } else {
@@ -4819,6 +4858,8 @@ static void process_new_connection(struct mg_connection *conn) {
       call_user(conn, MG_REQUEST_COMPLETE);
       log_access(conn);
     }
+    // Only the first request of a connection has been waiting in the queue
+    ri->queue_time = 0;
     if (ri->remote_user != NULL) {
       free((void *) ri->remote_user);
     }
@@ -4889,6 +4930,8 @@ static void worker_thread(struct mg_context *ctx) {
     while (consume_socket(ctx, &conn->client)) {
       conn->birth_time = time(NULL);
       conn->ctx = ctx;
+      conn->request_info.queue_time =
+        get_monotonic_time() - conn->client.accept_time;
 
       // Fill in IP, port info early so even if SSL setup below fails,
       // error handler would have the corresponding info.
@@ -4900,11 +4943,13 @@ static void worker_thread(struct mg_context *ctx) {
       conn->request_info.remote_ip = ntohl(conn->request_info.remote_ip);
       conn->request_info.is_ssl = conn->client.is_ssl;
 
+      ATOMIC_ADD(&ctx->busy_threads, 1);
       if (!conn->client.is_ssl ||
           (conn->client.is_ssl &&
            sslize(conn, conn->ctx->ssl_ctx, SSL_accept))) {
         process_new_connection(conn);
       }
+      ATOMIC_ADD(&ctx->busy_threads, -1);
 
       close_connection(conn);
     }
@@ -4955,9 +5000,15 @@ static void accept_new_connection(const struct socket *listener,
   if (accepted.sock != INVALID_SOCKET) {
     allowed = check_acl(ctx, ntohl(* (uint32_t *) &accepted.rsa.sin.sin_addr));
     if (allowed) {
+      // Replies are written as headers followed by the body. Without
+      // TCP_NODELAY the body would wait for the ACK of the header segment.
+      int on = 1;
+      (void) setsockopt(accepted.sock, IPPROTO_TCP, TCP_NODELAY,
+                        (const char *) &on, sizeof(on));
       // Put accepted socket structure into the queue
       DEBUG_TRACE(("accepted socket %d", accepted.sock));
       accepted.is_ssl = listener->is_ssl;
+      accepted.accept_time = get_monotonic_time();
       produce_socket(ctx, &accepted);
     } else {
       sockaddr_to_string(src_addr, sizeof(src_addr), &accepted.rsa);
@@ -49,6 +49,8 @@ struct mg_request_info {
   } http_headers[64];         // Maximum 64 headers
   void *user_data;            // User data pointer passed to the mg_start()
   void *ev_data;              // Event-specific data pointer
+  long long queue_time;       // Nanoseconds the connection waited in the
+                              // accept queue for a worker thread
 };
 
 
@@ -362,6 +364,21 @@ const char *mg_get_builtin_mime_type(const char *file_name);
 const char *mg_version(void);
 
 
+// Statistics of a running server.
+struct mg_stats {
+  int queued_connections;   // Accepted connections waiting for a worker thread
+  int busy_threads;         // Worker threads currently serving a connection
+  int num_threads;          // Configured number of worker threads
+  long long bytes_received; // Total bytes received from clients
+  long long bytes_sent;     // Total bytes sent to clients
+};
+
+
+// Fill in the statistics of the given server.
+// The counters are read without locking, so they are only a snapshot.
+void mg_get_stats(const struct mg_context *ctx, struct mg_stats *stats);
+
+
 // MD5 hash given strings.
 // Buffer 'buf' must be 33 bytes long. Varargs is a NULL terminated list of
 // ASCIIz strings. When function returns, buf will contain human-readable
@@ -11,11 +11,13 @@
 #include <iostream>
 #include <algorithm>
 #include <sstream>
+#include <set>
 
 #include <jsonrpc/rpc.h>
 #include <jsonrpc/procedure.h>
 
 #include "template.h"
+#include "typegenerator.h"
 
 using namespace std;
 using namespace jsonrpc;
@@ -43,7 +45,228 @@ void replace_all(string& text, const string& fnd, const string& rep)
     }
 }
 
-std::string generateMethod(Procedure& proc)
+/**
+ * Parses the specification, the procedure at each position is declared by the entry at the same position.
+ */
+std::vector<Procedure*> parseSpecification(const std::string& configfile,
+        Json::Value& specification)
+{
+    Json::Reader reader;
+    ifstream config(configfile.c_str());
+    if (!config)
+    {
+        throw Exception(ERROR_CONFIGURATIONFILE_NOT_FOUND, configfile);
+    }
+    if (!reader.parse(readfile(configfile), specification))
+    {
+        throw Exception(ERROR_PARSING_JSON);
+    }
+
+    vector<Procedure*> procedures;
+    for (unsigned int i = 0; i < specification.size(); i++)
+    {
+        procedures.push_back(new Procedure(specification[i]));
+    }
+    return procedures;
+}
+
+/**
+ * @return the literal of the parameter at the given position of Procedure::GetOrderedParameters.
+ */
+const Json::Value& getParameter(const Json::Value& signature,
+        unsigned int position, const std::string& name)
+{
+    const Json::Value& params = signature[KEY_PROCEDURE_PARAMETERS];
+    if (params.isArray())
+    {
+        return params[position][name];
+    }
+    return params[name];
+}
+
+/**
+ * The struct of a result is named after its method, e.g. GetPointResult.
+ */
+std::string getResultName(Procedure& proc)
+{
+    return proc.GetProcedureName() + "Result";
+}
+
+std::string toCppReturnType(Procedure& proc, const Json::Value& signature)
+{
+    if (proc.GetProcedureType() == RPC_NOTIFICATION)
+    {
+        return "void";
+    }
+    return TypeGenerator::GetType(signature[KEY_RETURN_TYPE], getResultName(proc));
+}
+
+std::string toJsonType(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_BOOLEAN:
+            return "jsonrpc::JSON_BOOLEAN";
+        case JSON_INTEGER:
+            return "jsonrpc::JSON_INTEGER";
+        case JSON_REAL:
+            return "jsonrpc::JSON_REAL";
+        case JSON_STRING:
+            return "jsonrpc::JSON_STRING";
+        case JSON_OBJECT:
+            return "jsonrpc::JSON_OBJECT";
+        default:
+            return "jsonrpc::JSON_ARRAY";
+    }
+}
+
+std::string toCppArgument(const Json::Value& literal, const std::string& argument)
+{
+    switch (literal.type())
+    {
+        case Json::intValue:
+        case Json::uintValue:
+            return argument + ".asInt()";
+        case Json::realValue:
+            return argument + ".asDouble()";
+        case Json::booleanValue:
+            return argument + ".asBool()";
+        case Json::stringValue:
+            return argument + ".asString()";
+        default:
+            return argument;
+    }
+}
+
+/**
+ * Generates the checks of all parameters, each with a single lookup (missing members are null and fail every type check).
+ * @param positional - if true, the parameters are looked up by index, otherwise by name.
+ */
+std::string generateParameterChecks(Procedure& proc, const Json::Value& signature,
+        bool positional, const std::string& indent)
+{
+    const string fail = "return ERROR_INVALID_PARAMS;";
+    const orderedparameterlist_t& list = proc.GetOrderedParameters();
+    stringstream validation;
+    for (unsigned int i = 0; i < list.size(); i++)
+    {
+        stringstream json;
+        if (positional)
+        {
+            json << "parameter[" << i << "u]";
+        }
+        else
+        {
+            json << "parameter[\"" << list[i].first << "\"]";
+        }
+        validation << TypeGenerator::GenerateValidation(
+                getParameter(signature, i, list[i].first), list[i].first,
+                json.str(), fail, indent);
+    }
+    return validation.str();
+}
+
+/**
+ * Generates the body of the compiled validator. Procedures declared by position accept positional and named params,
+ * the others only named params.
+ */
+std::string generateValidation(Procedure& proc, const Json::Value& signature)
+{
+    const string indent = "            ";
+    const string fail = "return ERROR_INVALID_PARAMS;";
+    stringstream validation;
+    if (proc.GetParameters().empty())
+    {
+        validation << indent << "if (parameter.isArray() && parameter.size() > 0)" << endl;
+        validation << indent << "    " << fail << endl;
+    }
+    else if (proc.GetParameterDeclaration() == PARAMS_BY_POSITION)
+    {
+        validation << indent << "if (parameter.isArray())" << endl;
+        validation << indent << "{" << endl;
+        validation << indent << "    if (parameter.size() != "
+                << proc.GetOrderedParameters().size() << ")" << endl;
+        validation << indent << "        " << fail << endl;
+        validation << generateParameterChecks(proc, signature, true, indent + "    ");
+        validation << indent << "}" << endl;
+        validation << indent << "else" << endl;
+        validation << indent << "{" << endl;
+        validation << indent << "    if (!parameter.isObject())" << endl;
+        validation << indent << "        " << fail << endl;
+        validation << generateParameterChecks(proc, signature, false, indent + "    ");
+        validation << indent << "}" << endl;
+    }
+    else
+    {
+        validation << indent << "if (!parameter.isObject())" << endl;
+        validation << indent << "    " << fail << endl;
+        validation << generateParameterChecks(proc, signature, false, indent);
+    }
+    validation << indent << "return ERROR_NO;" << endl;
+    return validation.str();
+}
+
+/**
+ * Searches a seed for RequestHandler::HashProcedureName which maps every procedure name to its own slot.
+ * @param slots - will hold the index of the procedure of each slot, -1 for empty slots.
+ * @return the seed.
+ */
+unsigned int generatePerfectHash(const vector<Procedure*>& procedures,
+        vector<int>& slots)
+{
+    size_t size = 1;
+    while (size < 2 * procedures.size())
+    {
+        size *= 2;
+    }
+    for (std::set<string> names; names.size() < procedures.size();)
+    {
+        if (!names.insert(procedures[names.size()]->GetProcedureName()).second)
+        {
+            throw Exception(ERROR_PROCEDURE_PARSE_ERROR,
+                    "procedure " + procedures[names.size()]->GetProcedureName() + " is declared twice");
+        }
+    }
+    while (true)
+    {
+        for (unsigned int seed = 0; seed < 10000; seed++)
+        {
+            slots.assign(size, -1);
+            bool collision = false;
+            for (unsigned int i = 0; i < procedures.size() && !collision; i++)
+            {
+                unsigned int slot = RequestHandler::HashProcedureName(
+                        procedures[i]->GetProcedureName(), seed) & (size - 1);
+                collision = slots[slot] >= 0;
+                slots[slot] = i;
+            }
+            if (!collision)
+            {
+                return seed;
+            }
+        }
+        size *= 2;
+    }
+}
+
+std::string generateParameterList(Procedure& proc, const Json::Value& signature)
+{
+    stringstream param_string;
+    const orderedparameterlist_t& list = proc.GetOrderedParameters();
+    for (unsigned int i = 0; i < list.size(); i++)
+    {
+        if (i > 0)
+        {
+            param_string << ", ";
+        }
+        param_string << TypeGenerator::GetParameterType(
+                getParameter(signature, i, list[i].first), list[i].first)
+                << " " << list[i].first;
+    }
+    return param_string.str();
+}
+
+std::string generateMethod(Procedure& proc, const Json::Value& signature)
 {
     string tmp = TEMPLATE_METHOD;
 
@@ -51,85 +274,293 @@ std::string generateMethod(Procedure& proc)
     replace_all(tmp, "<methodname>", proc.GetProcedureName());
 
     //build parameterlist
-    stringstream param_string;
     stringstream assignment_string;
+    const string indent = "            ";
 
-    parameterlist_t list = proc.GetParameters();
-    for (parameterlist_t::iterator it = list.begin(); it != list.end();)
+    const orderedparameterlist_t& list = proc.GetOrderedParameters();
+    for (unsigned int i = 0; i < list.size(); i++)
     {
-        string type;
-        switch (it->second)
+        const string& name = list[i].first;
+        const Json::Value& literal = getParameter(signature, i, name);
+        if (TypeGenerator::IsSimple(literal))
         {
-            case JSON_BOOLEAN:
-                type = "bool";
-                break;
-
-            case JSON_INTEGER:
-                type = "int";
-                break;
-            case JSON_REAL:
-                type = "double";
-                break;
-            case JSON_STRING:
-                type = "const std::string&";
-                break;
-            default:
-                type = "const Json::Value&";
-                break;
+            assignment_string << indent << "rpcRequest.AddParameter(\""
+                    << name << "\", " << name << ");" << endl;
         }
-
-        param_string << type << " " << it->first;
-        assignment_string << "p[\"" << it->first << "\"] = " << it->first
-                << "; " << endl;
-
-        if (++it != list.end())
+        else
         {
-            param_string << ", ";
+            assignment_string << indent << "{" << endl;
+            assignment_string << indent
+                    << "    std::string& out = rpcRequest.BeginParameter(\""
+                    << name << "\");" << endl;
+            assignment_string << TypeGenerator::GenerateWrite(literal, name,
+                    name, "out", indent + "    ");
+            assignment_string << indent << "}" << endl;
         }
     }
+    replace_all(tmp, "<positional>",
+            proc.GetParameterDeclaration() == PARAMS_BY_POSITION ? ", true" : "");
 
-    replace_all(tmp, "<parameters>", param_string.str());
+    replace_all(tmp, "<parameters>", generateParameterList(proc, signature));
     replace_all(tmp, "<parameter_assign>", assignment_string.str());
 
     if (proc.GetProcedureType() == RPC_METHOD)
     {
-        //TODO: add return type parsing
-        replace_all(tmp, "<return_type>", "Json::Value");
-        replace_all(tmp, "<return_statement>",
-                "return this->client->CallMethod(\"" + proc.GetProcedureName() + "\",p);");
+        replace_all(tmp, "<id>", "1");
+        replace_all(tmp, "<return_statement>", TEMPLATE_RETURN);
+        replace_all(tmp, "<read>",
+                TypeGenerator::GenerateRead(signature[KEY_RETURN_TYPE],
+                        getResultName(proc), "rpcResult", "returnValue",
+                        TEMPLATE_RETURN_FAILURE, indent));
     }
     else
     {
-        replace_all(tmp, "<return_type>", "void");
-        replace_all(tmp, "<return_statement>", "this->client->CallMethod(\"" + proc.GetProcedureName() + "\",p);");
+        replace_all(tmp, "<id>", "0");
+        replace_all(tmp, "<return_statement>", TEMPLATE_NOTIFICATION_RETURN);
     }
+    replace_all(tmp, "<return_type>", toCppReturnType(proc, signature));
 
     return tmp;
 }
 
-std::string generateStub(const string& stubname, const string& configfile)
+void replace_names(string& tmp, const string& stubname)
 {
-    string tmp = TEMPLATE_STUB;
     replace_all(tmp, "<stubname>", stubname);
 
     string stub_upper = stubname;
     std::transform(stub_upper.begin(), stub_upper.end(), stub_upper.begin(),
             ::toupper);
     replace_all(tmp, "<STUBNAME>", stub_upper);
+}
+
+std::string generateStub(const string& stubname, const string& types_include,
+        const vector<Procedure*>& procedures, const Json::Value& specification)
+{
+    string tmp = TEMPLATE_STUB;
+    replace_names(tmp, stubname);
+    replace_all(tmp, "<types_include>", types_include);
 
     //generate procedures
     stringstream procedure_string;
-    vector<Procedure*> procedures = Server::ParseProcedures(configfile);
-
-    for (int i = 0; i < procedures.size(); i++)
+    for (unsigned int i = 0; i < procedures.size(); i++)
     {
-        procedure_string << generateMethod(*procedures[i]) << endl;
+        procedure_string << generateMethod(*procedures[i], specification[i])
+                << endl;
     }
 
     replace_all(tmp, "<methods>", procedure_string.str());
     return tmp;
 }
 
+std::string generateTypes(const string& typesname, const TypeGenerator& types)
+{
+    string tmp = TEMPLATE_TYPES;
+    replace_names(tmp, typesname);
+    replace_all(tmp, "<structs>", types.GenerateStructs());
+    return tmp;
+}
+
+/**
+ * The server stub binds each procedure with its position in the specification as id, its dispatch code switches over
+ * this id, converts the arguments (in the order of the ordered parameterlist) and hands them to a pure virtual method with typed parameters.
+ * Constructed without configuration file, it creates its procedures from the compiled specification, with compiled
+ * validators, and finds them with a perfect hash of their names before the procedurelist is searched.
+ */
+std::string generateServerStub(const string& stubname, const string& types_include,
+        const vector<Procedure*>& procedures, const Json::Value& specification)
+{
+    string tmp = TEMPLATE_SERVER_STUB;
+    replace_all(tmp, "<types_include>", types_include);
+
+    stringstream bindings, methods, methodcalls, notificationcalls;
+    stringstream procedure_table, validators;
+    size_t maxparameters = 1;
+    bool named = false, positional = false;
+    const string indent = "                    ";
+
+    for (unsigned int i = 0; i < procedures.size(); i++)
+    {
+        Procedure& proc = *procedures[i];
+        const Json::Value& signature = specification[i];
+        stringstream id;
+        id << i;
+
+        stringstream declarations;
+        const orderedparameterlist_t& list = proc.GetOrderedParameters();
+        string parameterlist;
+        if (proc.GetParameterDeclaration() == PARAMS_BY_POSITION)
+        {
+            parameterlist = "positionalParameters";
+            positional = true;
+            declarations << "            positionalParameters.clear();" << endl;
+            for (unsigned int j = 0; j < list.size(); j++)
+            {
+                declarations << "            positionalParameters.push_back(std::make_pair(std::string(\""
+                        << list[j].first << "\"), " << toJsonType(list[j].second)
+                        << "));" << endl;
+            }
+        }
+        else
+        {
+            parameterlist = "parameters";
+            named = true;
+            declarations << "            parameters.clear();" << endl;
+            for (unsigned int j = 0; j < list.size(); j++)
+            {
+                declarations << "            parameters[\"" << list[j].first
+                        << "\"] = " << toJsonType(list[j].second) << ";" << endl;
+            }
+        }
+        stringstream return_declaration;
+        if (proc.HasReturnType())
+        {
+            return_declaration << "            this->procedures[" << i
+                    << "]->SetReturnType(" << toJsonType(proc.GetReturnType())
+                    << ");" << endl;
+        }
+        const string procedure_type = proc.GetProcedureType() == RPC_METHOD ?
+                "jsonrpc::RPC_METHOD" : "jsonrpc::RPC_NOTIFICATION";
+        string procedure = TEMPLATE_SERVER_PROCEDURE;
+        replace_all(procedure, "<return_declaration>", return_declaration.str());
+        replace_all(procedure, "<parameter_declarations>", declarations.str());
+        replace_all(procedure, "<parameterlist>", parameterlist);
+        replace_all(procedure, "<methodname>", proc.GetProcedureName());
+        replace_all(procedure, "<id>", id.str());
+        replace_all(procedure, "<procedure_type>", procedure_type);
+        procedure_table << procedure;
+
+        //the procedures of the configuration file are only bound, if they are declared like the compiled ones
+        string binding = TEMPLATE_SERVER_BINDING;
+        replace_all(binding, "<parameter_declarations>", declarations.str());
+        replace_all(binding, "<parameterlist>", parameterlist);
+        replace_all(binding, "<methodname>", proc.GetProcedureName());
+        replace_all(binding, "<id>", id.str());
+        replace_all(binding, "<procedure_type>", procedure_type);
+        bindings << binding;
+
+        string validator = TEMPLATE_SERVER_VALIDATOR;
+        replace_all(validator, "<methodname>", proc.GetProcedureName());
+        replace_all(validator, "<validation>", generateValidation(proc, signature));
+        validators << validator;
+
+        string method = TEMPLATE_SERVER_METHOD;
+        replace_all(method, "<methodname>", proc.GetProcedureName());
+        replace_all(method, "<parameters>", generateParameterList(proc, signature));
+        replace_all(method, "<return_type>", toCppReturnType(proc, signature));
+        methods << method;
+
+        //numbers, strings and Json::Values are passed directly, the others are converted into local variables first
+        stringstream arguments, conversions;
+        for (unsigned int position = 0; position < list.size(); position++)
+        {
+            const string& name = list[position].first;
+            const Json::Value& literal = getParameter(signature, position, name);
+            stringstream argument, variable;
+            argument << "(*arg[" << position << "])";
+            variable << "a" << position;
+            if (position > 0)
+            {
+                arguments << ", ";
+            }
+            if (TypeGenerator::IsSimple(literal))
+            {
+                arguments << toCppArgument(literal, argument.str());
+            }
+            else
+            {
+                conversions << indent
+                        << TypeGenerator::GetType(literal, name) << " "
+                        << variable.str() << ";" << endl;
+                conversions << TypeGenerator::GenerateFromJson(literal, name,
+                        argument.str(), variable.str(), indent);
+                arguments << variable.str();
+            }
+        }
+        maxparameters = std::max(maxparameters, list.size());
+
+        stringstream call;
+        string invocation = "this->" + proc.GetProcedureName() + "(" + arguments.str() + ")";
+        const Json::Value& result = signature[KEY_RETURN_TYPE];
+        if (proc.GetProcedureType() == RPC_NOTIFICATION)
+        {
+            call << indent << invocation << ";" << endl;
+        }
+        else if (TypeGenerator::IsSimple(result))
+        {
+            call << indent << "result = " << invocation << ";" << endl;
+        }
+        else
+        {
+            call << indent << toCppReturnType(proc, signature) << " returnValue = "
+                    << invocation << ";" << endl;
+            call << TypeGenerator::GenerateToJson(result, getResultName(proc),
+                    "returnValue", "result", indent);
+        }
+
+        string call_case = TEMPLATE_SERVER_CALL;
+        replace_all(call_case, "<id>", id.str());
+        replace_all(call_case, "<conversions>", conversions.str());
+        replace_all(call_case, "<call>", call.str());
+        if (proc.GetProcedureType() == RPC_METHOD)
+        {
+            methodcalls << call_case;
+        }
+        else
+        {
+            notificationcalls << call_case;
+        }
+    }
+
+    vector<int> slots;
+    unsigned int seed = generatePerfectHash(procedures, slots);
+    stringstream slot_string, seed_string, mask_string, size_string, count_string;
+    for (unsigned int i = 0; i < slots.size(); i++)
+    {
+        slot_string << (i > 0 ? ", " : "") << slots[i];
+    }
+    seed_string << seed << "u";
+    mask_string << slots.size() - 1;
+    size_string << slots.size();
+    count_string << std::max((size_t) 1, procedures.size());
+
+    stringstream maxparameters_string;
+    maxparameters_string << maxparameters;
+
+    stringstream parameterlists;
+    if (named)
+    {
+        parameterlists << "            jsonrpc::parameterlist_t parameters;" << endl;
+    }
+    if (positional)
+    {
+        parameterlists << "            jsonrpc::orderedparameterlist_t positionalParameters;" << endl;
+    }
+    replace_all(tmp, "<parameterlists>", parameterlists.str());
+    replace_all(tmp, "<procedures>", procedure_table.str());
+    replace_all(tmp, "<validators>", validators.str());
+    replace_all(tmp, "<slots>", slot_string.str());
+    replace_all(tmp, "<seed>", seed_string.str());
+    replace_all(tmp, "<mask>", mask_string.str());
+    replace_all(tmp, "<tablesize>", size_string.str());
+    replace_all(tmp, "<numprocedures>", count_string.str());
+
+    replace_all(tmp, "<bindings>", bindings.str());
+    replace_all(tmp, "<methods>", methods.str());
+    replace_all(tmp, "<maxparameters>", maxparameters_string.str());
+    replace_all(tmp, "<methodcalls>", methodcalls.str());
+    replace_all(tmp, "<notificationcalls>", notificationcalls.str());
+    replace_names(tmp, stubname);
+    return tmp;
+}
+
+void writefile(const std::string& filename, const std::string& content)
+{
+    ofstream myfile;
+    myfile.open(filename.c_str());
+    myfile << content;
+    myfile.close();
+}
+
 int main(int argc, char** argv)
 {
     try
@@ -137,19 +568,58 @@ int main(int argc, char** argv)
         if (argc < 3)
         {
             cerr << "call stub jsonrpc generator with: " << endl
-                    << "\tjsonrpcstub <StubName> <Json-Specification>" << endl;
+                    << "\tjsonrpcstub <StubName> <Json-Specification>" << endl
+                    << "It generates the client stub <StubName>.h, the abstract server <StubName>Server.h" << endl
+                    << "and, if the specification declares structs, <StubName>Types.h" << endl;
             return -1;
         }
         else
         {
-            ofstream myfile;
-            string filename = argv[1];
-            filename = filename + ".h";
-            myfile.open(filename.c_str());
-            myfile << generateStub(argv[1], argv[2]);
-            myfile.close();
+            string stubname = argv[1];
+            Json::Value specification;
+            vector<Procedure*> procedures = parseSpecification(argv[2], specification);
 
+            TypeGenerator types;
+            for (unsigned int i = 0; i < procedures.size(); i++)
+            {
+                const orderedparameterlist_t& list =
+                        procedures[i]->GetOrderedParameters();
+                for (unsigned int j = 0; j < list.size(); j++)
+                {
+                    types.AddType(getParameter(specification[i], j, list[j].first),
+                            list[j].first);
+                }
+                if (procedures[i]->GetProcedureType() == RPC_METHOD)
+                {
+                    types.AddType(specification[i][KEY_RETURN_TYPE],
+                            getResultName(*procedures[i]));
+                }
+            }
+
+            string types_include;
+            if (types.HasStructs())
+            {
+                string filename = stubname + "Types.h";
+                writefile(filename, generateTypes(stubname + "Types", types));
+                types_include = "#include \"" + filename + "\"\n";
+                cout << "Types generated into " << filename << endl;
+            }
+
+            string filename = stubname + ".h";
+            writefile(filename,
+                    generateStub(stubname, types_include, procedures, specification));
             cout << "Stub generated into " << filename << endl;
+
+            filename = stubname + "Server.h";
+            writefile(filename,
+                    generateServerStub(stubname + "Server", types_include,
+                            procedures, specification));
+            cout << "Server stub generated into " << filename << endl;
+
+            for (unsigned int i = 0; i < procedures.size(); i++)
+            {
+                delete procedures[i];
+            }
         }
     }
     catch (Exception& e)
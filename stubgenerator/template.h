@@ -2,14 +2,30 @@
 #define TEMPLATE_H_
 
 #define TEMPLATE_METHOD "\
-        <return_type> <methodname>(<parameters>)\n\
+        <return_type> <methodname>(<parameters>) throw (jsonrpc::Exception)\n\
         {\n\
-            Json::Value p;\n\
-            <parameter_assign>\n\
-            <return_statement>\n\
+            jsonrpc::RequestBuffer rpcRequest;\n\
+            rpcRequest.Begin(\"<methodname>\", <id><positional>);\n\
+<parameter_assign>\
+<return_statement>\
         }\n\
 "
 
+#define TEMPLATE_RETURN "\
+            std::string rpcResponse;\n\
+            jsonrpc::JsonScanner rpcResult;\n\
+            this->client->CallMethod(rpcRequest, rpcResponse, rpcResult);\n\
+            <return_type> returnValue;\n\
+<read>\
+            return returnValue;\n\
+"
+
+#define TEMPLATE_RETURN_FAILURE "throw jsonrpc::Exception(ERROR_PARSING_JSON, rpcResponse);"
+
+#define TEMPLATE_NOTIFICATION_RETURN "\
+            this->client->CallNotification(rpcRequest);\n\
+"
+
 #define TEMPLATE_STUB "\
 /**\n\
  * THIS FILE IS GENERATED BY jsonrpcstub, DO NOT CHANGE IT!!!!!\n\
@@ -22,7 +38,12 @@
 #include <jsonrpc/client.h>\n\
 #include <string>\n\
 #include <json/json.h>\n\
+<types_include>\
 \n\
+/**\n\
+ * Requests are written directly into a buffer and results are read directly out of the response.\n\
+ * Each call has its own buffers, so the stub may be called by several threads at once, if its connector allows it.\n\
+ */\n\
 class <stubname>\n\
 {\n\
     public:\n\
@@ -41,4 +62,145 @@ class <stubname>\n\
 #endif //_<STUBNAME>_H_\n\
 "
 
+#define TEMPLATE_SERVER_METHOD "\
+        virtual <return_type> <methodname>(<parameters>) = 0;\n\
+"
+
+#define TEMPLATE_SERVER_BINDING "\
+<parameter_declarations>\
+            if (!this->BindProcedure(jsonrpc::Procedure(\"<methodname>\", <procedure_type>, <parameterlist>), this, <id>, &<stubname>::Validate_<methodname>))\n\
+                throw jsonrpc::Exception(ERROR_METHOD_NOT_FOUND, \"<methodname>\");\n\
+"
+
+#define TEMPLATE_SERVER_PROCEDURE "\
+<parameter_declarations>\
+            this->procedures[<id>] = new jsonrpc::Procedure(\"<methodname>\", <procedure_type>, <parameterlist>);\n\
+<return_declaration>\
+            this->procedures[<id>]->SetValidator(&<stubname>::Validate_<methodname>);\n\
+            this->procedures[<id>]->SetHandler(this, <id>);\n\
+            this->GetHandler().AddProcedure(this->procedures[<id>]);\n\
+            if (!this->GetHandler().GetProcedureRegistry().Acquire(this->procedures[<id>]))\n\
+                this->procedures[<id>] = NULL;\n\
+"
+
+#define TEMPLATE_SERVER_VALIDATOR "\
+        static int Validate_<methodname>(const Json::Value& parameter)\n\
+        {\n\
+<validation>\
+        }\n\
+\n\
+"
+
+#define TEMPLATE_SERVER_CALL "\
+                case <id>:\n\
+                {\n\
+<conversions>\
+<call>\
+                    break;\n\
+                }\n\
+"
+
+#define TEMPLATE_TYPES "\
+/**\n\
+ * THIS FILE IS GENERATED BY jsonrpcstub, DO NOT CHANGE IT!!!!!\n\
+ */\n\
+\n\
+#ifndef _<STUBNAME>_H_\n\
+#define _<STUBNAME>_H_\n\
+\n\
+#include <jsonrpc/requestbuffer.h>\n\
+#include <jsonrpc/jsonscanner.h>\n\
+#include <string>\n\
+#include <vector>\n\
+#include <json/json.h>\n\
+\n\
+<structs>\
+#endif //_<STUBNAME>_H_\n\
+"
+
+#define TEMPLATE_SERVER_STUB "\
+/**\n\
+ * THIS FILE IS GENERATED BY jsonrpcstub, DO NOT CHANGE IT!!!!!\n\
+ */\n\
+\n\
+#ifndef _<STUBNAME>_H_\n\
+#define _<STUBNAME>_H_\n\
+\n\
+#include <jsonrpc/rpc.h>\n\
+#include <string>\n\
+#include <json/json.h>\n\
+<types_include>\
+\n\
+class <stubname> : public jsonrpc::Server, public jsonrpc::ProcedureHandler\n\
+{\n\
+    public:\n\
+        <stubname>(const std::string& name, const std::string& configfile, jsonrpc::ServerConnector* conn, jsonrpc::Authenticator* auth = NULL)\n\
+            : jsonrpc::Server(name, configfile, conn, auth)\n\
+        {\n\
+<parameterlists>\
+            for (int i = 0; i < <numprocedures>; i++)\n\
+                this->procedures[i] = NULL;\n\
+<bindings>\
+        }\n\
+\n\
+        <stubname>(const std::string& name, jsonrpc::ServerConnector* conn, jsonrpc::Authenticator* auth = NULL)\n\
+            : jsonrpc::Server(name, conn, auth)\n\
+        {\n\
+<parameterlists>\
+<procedures>\
+            this->GetHandler().SetProcedureLookup(&<stubname>::FindProcedure, this);\n\
+        }\n\
+\n\
+        virtual ~<stubname>()\n\
+        {\n\
+            this->GetHandler().SetProcedureLookup(NULL, NULL);\n\
+            for (int i = 0; i < <numprocedures>; i++)\n\
+                if (this->procedures[i] != NULL)\n\
+                    this->GetHandler().GetProcedureRegistry().Release(this->procedures[i]);\n\
+        }\n\
+\n\
+<methods>\
+\n\
+        virtual void HandleMethodCall(jsonrpc::Procedure& procedure, const Json::Value& parameter, Json::Value& result)\n\
+        {\n\
+            const Json::Value* arg[<maxparameters>];\n\
+            jsonrpc::ProcedureHandler::GetArguments(procedure, parameter, arg);\n\
+            switch (procedure.GetHandlerId())\n\
+            {\n\
+<methodcalls>\
+            }\n\
+        }\n\
+\n\
+        virtual void HandleNotificationCall(jsonrpc::Procedure& procedure, const Json::Value& parameter)\n\
+        {\n\
+            const Json::Value* arg[<maxparameters>];\n\
+            jsonrpc::ProcedureHandler::GetArguments(procedure, parameter, arg);\n\
+            switch (procedure.GetHandlerId())\n\
+            {\n\
+<notificationcalls>\
+            }\n\
+        }\n\
+\n\
+    private:\n\
+        /**\n\
+         * The compiled procedures, with a reference each, so FindProcedure can return them even after they have been removed.\n\
+         */\n\
+        jsonrpc::Procedure* procedures[<numprocedures>];\n\
+\n\
+<validators>\
+        static jsonrpc::Procedure* FindProcedure(void* server, const std::string& name)\n\
+        {\n\
+            static const int slots[<tablesize>] = { <slots> };\n\
+            int slot = slots[jsonrpc::RequestHandler::HashProcedureName(name, <seed>) & <mask>];\n\
+            if (slot >= 0 && ((<stubname>*) server)->procedures[slot] != NULL\n\
+                    && ((<stubname>*) server)->procedures[slot]->GetProcedureName() == name)\n\
+            {\n\
+                return ((<stubname>*) server)->procedures[slot];\n\
+            }\n\
+            return NULL;\n\
+        }\n\
+};\n\
+#endif //_<STUBNAME>_H_\n\
+"
+
 #endif
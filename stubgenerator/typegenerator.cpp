@@ -0,0 +1,420 @@
+/**
+ * @file typegenerator.cpp
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Generates the C++ types of parameters and results, and the code to convert them from and to JSON.
+ */
+
+#include "typegenerator.h"
+
+#include <sstream>
+#include <jsonrpc/exception.h>
+
+using namespace std;
+using namespace jsonrpc;
+
+void TypeGenerator::AddType(const Json::Value& literal, const std::string& name)
+{
+    if (IsVector(literal))
+    {
+        this->AddType(literal[0u], name);
+    }
+    else if (IsStruct(literal))
+    {
+        string structName = GetStructName(name);
+        map<string, Json::Value>::iterator it = this->structs.find(structName);
+        if (it != this->structs.end())
+        {
+            if (GetShape(it->second) != GetShape(literal))
+            {
+                throw Exception(ERROR_PROCEDURE_PARSE_ERROR,
+                        "struct " + structName + " is declared with different members");
+            }
+            return;
+        }
+
+        //members first, their definitions have to precede this struct
+        vector<string> members = literal.getMemberNames();
+        for (unsigned int i = 0; i < members.size(); i++)
+        {
+            this->AddType(literal[members[i]], members[i]);
+        }
+        this->structs[structName] = literal;
+        this->order.push_back(structName);
+    }
+}
+
+bool TypeGenerator::HasStructs() const
+{
+    return !this->order.empty();
+}
+
+std::string TypeGenerator::GenerateStructs() const
+{
+    stringstream result;
+    for (unsigned int i = 0; i < this->order.size(); i++)
+    {
+        result << this->GenerateStruct(this->order[i],
+                this->structs.find(this->order[i])->second) << endl;
+    }
+    return result.str();
+}
+
+std::string TypeGenerator::GetType(const Json::Value& literal, const std::string& name)
+{
+    switch (literal.type())
+    {
+        case Json::intValue:
+        case Json::uintValue:
+            return "int";
+        case Json::realValue:
+            return "double";
+        case Json::booleanValue:
+            return "bool";
+        case Json::stringValue:
+            return "std::string";
+        default:
+            if (IsStruct(literal))
+            {
+                return GetStructName(name);
+            }
+            if (IsVector(literal))
+            {
+                //C++98 needs the space between closing angle brackets
+                return "std::vector<" + GetType(literal[0u], name) + " >";
+            }
+            return "Json::Value";
+    }
+}
+
+std::string TypeGenerator::GetParameterType(const Json::Value& literal, const std::string& name)
+{
+    if (literal.isNumeric() || literal.isBool())
+    {
+        return GetType(literal, name);
+    }
+    return "const " + GetType(literal, name) + "&";
+}
+
+bool TypeGenerator::IsSimple(const Json::Value& literal)
+{
+    return !IsStruct(literal) && !IsVector(literal);
+}
+
+std::string TypeGenerator::GenerateValidation(const Json::Value& literal,
+        const std::string& name, const std::string& json, const std::string& fail,
+        const std::string& indent, int depth)
+{
+    stringstream code;
+    string check;
+    switch (literal.type())
+    {
+        case Json::intValue:
+        case Json::uintValue:
+            check = json + ".isInt()";
+            break;
+        case Json::realValue:
+            check = json + ".isDouble()";
+            break;
+        case Json::booleanValue:
+            check = json + ".isBool()";
+            break;
+        case Json::stringValue:
+            check = json + ".isString()";
+            break;
+        case Json::objectValue:
+            check = IsStruct(literal) ?
+                    GetStructName(name) + "::IsValid(" + json + ")" :
+                    json + ".isObject()";
+            break;
+        case Json::arrayValue:
+            check = json + ".isArray()";
+            break;
+        default:
+            return "";
+    }
+    code << indent << "if (!" << check << ")" << endl;
+    code << indent << "    " << fail << endl;
+
+    if (IsVector(literal))
+    {
+        stringstream index;
+        index << "i" << depth;
+        code << indent << "for (unsigned int " << index.str() << " = 0; " << index.str()
+                << " < " << json << ".size(); " << index.str() << "++)" << endl;
+        code << indent << "{" << endl;
+        code << GenerateValidation(literal[0u], name, json + "[" + index.str() + "]",
+                fail, indent + "    ", depth + 1);
+        code << indent << "}" << endl;
+    }
+    return code.str();
+}
+
+std::string TypeGenerator::GenerateFromJson(const Json::Value& literal,
+        const std::string& name, const std::string& json, const std::string& target,
+        const std::string& indent, int depth)
+{
+    stringstream code;
+    switch (literal.type())
+    {
+        case Json::intValue:
+        case Json::uintValue:
+            code << indent << target << " = " << json << ".asInt();" << endl;
+            break;
+        case Json::realValue:
+            code << indent << target << " = " << json << ".asDouble();" << endl;
+            break;
+        case Json::booleanValue:
+            code << indent << target << " = " << json << ".asBool();" << endl;
+            break;
+        case Json::stringValue:
+            code << indent << target << " = " << json << ".asString();" << endl;
+            break;
+        default:
+            if (IsStruct(literal))
+            {
+                code << indent << target << ".FromJson(" << json << ");" << endl;
+            }
+            else if (IsVector(literal))
+            {
+                stringstream index;
+                index << "i" << depth;
+                code << indent << target << ".resize(" << json << ".size());" << endl;
+                code << indent << "for (unsigned int " << index.str() << " = 0; " << index.str()
+                        << " < " << json << ".size(); " << index.str() << "++)" << endl;
+                code << indent << "{" << endl;
+                code << GenerateFromJson(literal[0u], name, json + "[" + index.str() + "]",
+                        target + "[" + index.str() + "]", indent + "    ", depth + 1);
+                code << indent << "}" << endl;
+            }
+            else
+            {
+                code << indent << target << " = " << json << ";" << endl;
+            }
+            break;
+    }
+    return code.str();
+}
+
+std::string TypeGenerator::GenerateToJson(const Json::Value& literal,
+        const std::string& name, const std::string& source, const std::string& json,
+        const std::string& indent, int depth)
+{
+    stringstream code;
+    if (IsStruct(literal))
+    {
+        code << indent << source << ".ToJson(" << json << ");" << endl;
+    }
+    else if (IsVector(literal))
+    {
+        stringstream index;
+        index << "i" << depth;
+        code << indent << json << " = Json::Value(Json::arrayValue);" << endl;
+        code << indent << "for (unsigned int " << index.str() << " = 0; " << index.str()
+                << " < " << source << ".size(); " << index.str() << "++)" << endl;
+        code << indent << "{" << endl;
+        code << GenerateToJson(literal[0u], name, source + "[" + index.str() + "]",
+                json + "[" + index.str() + "]", indent + "    ", depth + 1);
+        code << indent << "}" << endl;
+    }
+    else
+    {
+        code << indent << json << " = " << source << ";" << endl;
+    }
+    return code.str();
+}
+
+std::string TypeGenerator::GenerateWrite(const Json::Value& literal,
+        const std::string& name, const std::string& source, const std::string& buffer,
+        const std::string& indent, int depth)
+{
+    stringstream code;
+    if (IsStruct(literal))
+    {
+        code << indent << source << ".Write(" << buffer << ");" << endl;
+    }
+    else if (IsVector(literal))
+    {
+        stringstream index;
+        index << "i" << depth;
+        code << indent << buffer << " += '[';" << endl;
+        code << indent << "for (unsigned int " << index.str() << " = 0; " << index.str()
+                << " < " << source << ".size(); " << index.str() << "++)" << endl;
+        code << indent << "{" << endl;
+        code << indent << "    if (" << index.str() << " > 0)" << endl;
+        code << indent << "        " << buffer << " += ',';" << endl;
+        code << GenerateWrite(literal[0u], name, source + "[" + index.str() + "]",
+                buffer, indent + "    ", depth + 1);
+        code << indent << "}" << endl;
+        code << indent << buffer << " += ']';" << endl;
+    }
+    else
+    {
+        code << indent << "jsonrpc::RequestBuffer::Append(" << buffer << ", " << source
+                << ");" << endl;
+    }
+    return code.str();
+}
+
+std::string TypeGenerator::GenerateRead(const Json::Value& literal,
+        const std::string& name, const std::string& scanner, const std::string& target,
+        const std::string& fail, const std::string& indent, int depth)
+{
+    stringstream code;
+    if (IsStruct(literal))
+    {
+        code << indent << "if (!" << target << ".Read(" << scanner << "))" << endl;
+        code << indent << "    " << fail << endl;
+    }
+    else if (IsVector(literal))
+    {
+        code << indent << "if (!" << scanner << ".BeginArray())" << endl;
+        code << indent << "    " << fail << endl;
+        code << indent << target << ".clear();" << endl;
+        code << indent << "while (" << scanner << ".NextElement())" << endl;
+        code << indent << "{" << endl;
+        code << indent << "    " << target << ".resize(" << target << ".size() + 1);" << endl;
+        code << GenerateRead(literal[0u], name, scanner, target + ".back()", fail,
+                indent + "    ", depth + 1);
+        code << indent << "}" << endl;
+    }
+    else
+    {
+        code << indent << "if (!" << scanner << ".Read(" << target << "))" << endl;
+        code << indent << "    " << fail << endl;
+    }
+    return code.str();
+}
+
+std::string TypeGenerator::GenerateStruct(const std::string& name,
+        const Json::Value& literal) const
+{
+    const string indent = "        ";
+    vector<string> members = literal.getMemberNames();
+    stringstream code, initializers;
+
+    code << "struct " << name << endl << "{" << endl;
+    for (unsigned int i = 0; i < members.size(); i++)
+    {
+        const Json::Value& member = literal[members[i]];
+        code << "    " << GetType(member, members[i]) << " " << members[i] << ";" << endl;
+        if (member.isNumeric() || member.isBool())
+        {
+            initializers << (initializers.str().empty() ? "" : ", ") << members[i]
+                    << (member.isBool() ? "(false)" : "(0)");
+        }
+    }
+
+    code << endl << "    " << name << "()" << endl;
+    if (!initializers.str().empty())
+    {
+        code << "        : " << initializers.str() << endl;
+    }
+    code << "    {" << endl << "    }" << endl << endl;
+
+    code << "    static bool IsValid(const Json::Value& value)" << endl << "    {" << endl;
+    code << indent << "if (!value.isObject())" << endl;
+    code << indent << "    return false;" << endl;
+    for (unsigned int i = 0; i < members.size(); i++)
+    {
+        code << GenerateValidation(literal[members[i]], members[i],
+                "value[\"" + members[i] + "\"]", "return false;", indent);
+    }
+    code << indent << "return true;" << endl << "    }" << endl << endl;
+
+    code << "    /**" << endl
+            << "     * @pre IsValid(value)" << endl
+            << "     */" << endl;
+    code << "    void FromJson(const Json::Value& value)" << endl << "    {" << endl;
+    for (unsigned int i = 0; i < members.size(); i++)
+    {
+        code << GenerateFromJson(literal[members[i]], members[i],
+                "value[\"" + members[i] + "\"]", "this->" + members[i], indent);
+    }
+    code << "    }" << endl << endl;
+
+    code << "    void ToJson(Json::Value& value) const" << endl << "    {" << endl;
+    for (unsigned int i = 0; i < members.size(); i++)
+    {
+        code << GenerateToJson(literal[members[i]], members[i], "this->" + members[i],
+                "value[\"" + members[i] + "\"]", indent);
+    }
+    code << "    }" << endl << endl;
+
+    code << "    void Write(std::string& buffer) const" << endl << "    {" << endl;
+    for (unsigned int i = 0; i < members.size(); i++)
+    {
+        code << indent << "buffer += \"" << (i == 0 ? "{" : ",") << "\\\"" << members[i]
+                << "\\\":\";" << endl;
+        code << GenerateWrite(literal[members[i]], members[i], "this->" + members[i],
+                "buffer", indent);
+    }
+    code << indent << "buffer += '}';" << endl << "    }" << endl << endl;
+
+    code << "    /**" << endl
+            << "     * Members missing in the input keep their values, unknown members are skipped." << endl
+            << "     */" << endl;
+    code << "    bool Read(jsonrpc::JsonScanner& scanner)" << endl << "    {" << endl;
+    code << indent << "const char* member;" << endl;
+    code << indent << "size_t length;" << endl;
+    code << indent << "if (!scanner.BeginObject())" << endl;
+    code << indent << "    return false;" << endl;
+    code << indent << "while (scanner.NextMember(member, length))" << endl;
+    code << indent << "{" << endl;
+    for (unsigned int i = 0; i < members.size(); i++)
+    {
+        code << indent << "    " << (i == 0 ? "" : "else ")
+                << "if (jsonrpc::JsonScanner::Matches(member, length, \"" << members[i]
+                << "\"))" << endl;
+        code << indent << "    {" << endl;
+        code << GenerateRead(literal[members[i]], members[i], "scanner",
+                "this->" + members[i], "return false;", indent + "        ");
+        code << indent << "    }" << endl;
+    }
+    code << indent << "    else if (!scanner.Skip())" << endl;
+    code << indent << "        return false;" << endl;
+    code << indent << "}" << endl;
+    code << indent << "return !scanner.Failed();" << endl << "    }" << endl;
+
+    code << "};" << endl;
+    return code.str();
+}
+
+bool TypeGenerator::IsStruct(const Json::Value& literal)
+{
+    return literal.isObject() && literal.size() > 0;
+}
+
+bool TypeGenerator::IsVector(const Json::Value& literal)
+{
+    return literal.isArray() && literal.size() > 0;
+}
+
+std::string TypeGenerator::GetStructName(const std::string& name)
+{
+    string result = name;
+    if (!result.empty())
+    {
+        result[0] = toupper(result[0]);
+    }
+    return result;
+}
+
+std::string TypeGenerator::GetShape(const Json::Value& literal)
+{
+    if (IsStruct(literal))
+    {
+        string shape = "{";
+        vector<string> members = literal.getMemberNames();
+        for (unsigned int i = 0; i < members.size(); i++)
+        {
+            shape += members[i] + ":" + GetShape(literal[members[i]]) + ",";
+        }
+        return shape + "}";
+    }
+    if (IsVector(literal))
+    {
+        return "[" + GetShape(literal[0u]) + "]";
+    }
+    return GetType(literal, "");
+}
@@ -0,0 +1,87 @@
+/**
+ * @file typegenerator.h
+ * @date 18.10.2026
+ * @author Peter Spiess-Knafl <peter.knafl@gmail.com>
+ * @brief Generates the C++ types of parameters and results, and the code to convert them from and to JSON.
+ */
+
+#ifndef TYPEGENERATOR_H_
+#define TYPEGENERATOR_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <json/json.h>
+
+/**
+ * Types are declared by literals in the specification, like the parameters of a procedure:
+ * an object literal with members declares a struct, which is named after its parameter (or member),
+ * e.g. "point" : { "x" : 0, "y" : 0 } declares struct Point, and the result of a method getPoint is named GetPointResult.
+ * An array literal with an element declares a std::vector of the type of this element.
+ * Empty objects and arrays stay Json::Value.
+ */
+class TypeGenerator
+{
+    public:
+        /**
+         * Registers all structs declared by the literal.
+         * @throws jsonrpc::Exception if a struct with the same name but other members has already been registered.
+         */
+        void AddType(const Json::Value& literal, const std::string& name);
+
+        bool HasStructs() const;
+
+        /**
+         * @return the definitions of all registered structs, each one after the structs of its members.
+         */
+        std::string GenerateStructs() const;
+
+        /**
+         * @return the C++ type of a value.
+         */
+        static std::string GetType(const Json::Value& literal, const std::string& name);
+
+        /**
+         * @return the C++ type of a parameter, which is passed by const reference unless it is a number or bool.
+         */
+        static std::string GetParameterType(const Json::Value& literal, const std::string& name);
+
+        /**
+         * @return true for the types which can be read and written directly by JsonScanner and RequestBuffer.
+         */
+        static bool IsSimple(const Json::Value& literal);
+
+        /**
+         * The following generate statements, indented by indent, which convert between the variable target (or source)
+         * and a Json::Value, a buffer of a RequestBuffer or a JsonScanner. Failures execute the statement fail.
+         * @param depth - nesting level of loops, to name their indices.
+         */
+        static std::string GenerateValidation(const Json::Value& literal, const std::string& name,
+                const std::string& json, const std::string& fail, const std::string& indent, int depth = 0);
+        static std::string GenerateFromJson(const Json::Value& literal, const std::string& name,
+                const std::string& json, const std::string& target, const std::string& indent, int depth = 0);
+        static std::string GenerateToJson(const Json::Value& literal, const std::string& name,
+                const std::string& source, const std::string& json, const std::string& indent, int depth = 0);
+        static std::string GenerateWrite(const Json::Value& literal, const std::string& name,
+                const std::string& source, const std::string& buffer, const std::string& indent, int depth = 0);
+        static std::string GenerateRead(const Json::Value& literal, const std::string& name,
+                const std::string& scanner, const std::string& target, const std::string& fail,
+                const std::string& indent, int depth = 0);
+
+    private:
+        std::string GenerateStruct(const std::string& name, const Json::Value& literal) const;
+
+        static bool IsStruct(const Json::Value& literal);
+        static bool IsVector(const Json::Value& literal);
+        static std::string GetStructName(const std::string& name);
+
+        /**
+         * @return the member names and types of a literal, used to compare two declarations of a struct.
+         */
+        static std::string GetShape(const Json::Value& literal);
+
+        std::map<std::string, Json::Value> structs;
+        std::vector<std::string> order;
+};
+
+#endif /* TYPEGENERATOR_H_ */